@@ -0,0 +1,80 @@
+// Insert and find throughput of LockFreeSkipList against a SkipList behind
+// one mutex, for 1 to 64 threads.
+//
+//   g++ -std=c++17 -O2 -pthread bench/skiplist_lockfree.cpp -o skiplist_lockfree
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../src/skiplist.hpp"
+#include "../src/skiplist_lockfree.hpp"
+
+static const long OPERATIONS = 2000000;
+static const int KEYS = 1 << 22;
+
+// Runs OPERATIONS calls of op(thread, i) split over threads; returns
+// millions of operations per second.
+template <class F>
+double throughput(int threads, F op) {
+	std::vector<std::thread> workers;
+	auto start = std::chrono::steady_clock::now();
+	for (int t = 0; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			for (long i = t; i < OPERATIONS; i += threads) op(i);
+		});
+	}
+	for (std::thread & worker : workers) worker.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return OPERATIONS / seconds / 1e6;
+}
+
+int main() {
+	std::vector<int> keys(OPERATIONS);
+	std::mt19937 random(1);
+	for (int & key : keys) key = random() % KEYS;
+
+	std::printf("threads  lock-free insert  find  mixed   mutex insert  find  mixed  (Mops/s)\n");
+	for (int threads = 1; threads <= 64; threads *= 2) {
+		LockFreeSkipList<int> lockfree;
+		SkipList<int> locked;
+		std::mutex mutex;
+
+		double lockfreeInsert = throughput(threads, [&](long i) { lockfree.insert(keys[i]); });
+		double lockfreeFind = throughput(threads, [&](long i) { lockfree.find(keys[OPERATIONS - 1 - i]); });
+		// One insert and one remove per two finds.
+		double lockfreeMixed = throughput(threads, [&](long i) {
+			int key = keys[i] ^ 1;
+			switch (i & 3) {
+			case 0: lockfree.insert(key); break;
+			case 1: lockfree.remove(key); break;
+			default: lockfree.find(key);
+			}
+		});
+
+		double lockedInsert = throughput(threads, [&](long i) {
+			std::lock_guard<std::mutex> guard(mutex);
+			locked.insert(keys[i]);
+		});
+		double lockedFind = throughput(threads, [&](long i) {
+			std::lock_guard<std::mutex> guard(mutex);
+			locked.find(keys[OPERATIONS - 1 - i]);
+		});
+		double lockedMixed = throughput(threads, [&](long i) {
+			int key = keys[i] ^ 1;
+			std::lock_guard<std::mutex> guard(mutex);
+			switch (i & 3) {
+			case 0: locked.insert(key); break;
+			case 1: locked.remove(key); break;
+			default: locked.find(key);
+			}
+		});
+
+		std::printf("%7d  %16.2f  %4.2f  %5.2f   %12.2f  %4.2f  %5.2f\n", threads,
+			lockfreeInsert, lockfreeFind, lockfreeMixed, lockedInsert, lockedFind, lockedMixed);
+	}
+	return 0;
+}
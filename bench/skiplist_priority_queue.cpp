@@ -0,0 +1,71 @@
+// Push and pop_min throughput of SkipListPriorityQueue against a
+// std::priority_queue behind one mutex, for 1 to 64 threads.
+//
+//   g++ -std=c++17 -O2 -pthread bench/skiplist_priority_queue.cpp -o skiplist_priority_queue
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../src/skiplist_priority_queue.hpp"
+
+static const long OPERATIONS = 2000000;
+static const int PREFILL = 100000;
+static const int KEYS = 1 << 22;
+
+// Runs OPERATIONS calls of op(i) split over threads; returns millions of
+// operations per second.
+template <class F>
+double throughput(int threads, F op) {
+	std::vector<std::thread> workers;
+	auto start = std::chrono::steady_clock::now();
+	for (int t = 0; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			for (long i = t; i < OPERATIONS; i += threads) op(i);
+		});
+	}
+	for (std::thread & worker : workers) worker.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return OPERATIONS / seconds / 1e6;
+}
+
+int main() {
+	std::vector<int> keys(OPERATIONS);
+	std::mt19937 random(1);
+	for (int & key : keys) key = random() % KEYS;
+
+	std::printf("threads  skiplist queue  mutex priority_queue  (Mops/s, half push, half pop_min)\n");
+	for (int threads = 1; threads <= 64; threads *= 2) {
+		SkipListPriorityQueue<int> queue;
+		std::priority_queue<int, std::vector<int>, std::greater<int>> heap;
+		std::mutex mutex;
+		for (int i = 0; i < PREFILL; i++) {
+			queue.push(keys[i]);
+			heap.push(keys[i]);
+		}
+
+		double lockfree = throughput(threads, [&](long i) {
+			if (i & 1) {
+				queue.push(keys[i]);
+			} else {
+				queue.pop_min();
+			}
+		});
+		double locked = throughput(threads, [&](long i) {
+			std::lock_guard<std::mutex> guard(mutex);
+			if (i & 1) {
+				heap.push(keys[i]);
+			} else if (!heap.empty()) {
+				heap.pop();
+			}
+		});
+
+		std::printf("%7d  %14.2f  %20.2f\n", threads, lockfree, locked);
+	}
+	return 0;
+}
@@ -0,0 +1,66 @@
+// SplayTree::find_batch and insert_batch against looping over find() and
+// insert(), for sparse and dense batches over a tree of 1M keys.
+//
+//   g++ -std=c++17 -O2 bench/splay_batch.cpp -o splay_batch
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../src/splay_tree.hpp"
+
+static const long KEYS = 1000000;
+
+static double milliseconds(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+	std::mt19937_64 random(1);
+	// Even keys are present, odd ones are not.
+	std::vector<long> present(KEYS);
+	for (long i = 0; i < KEYS; i++) present[i] = 2 * i;
+	std::shuffle(present.begin(), present.end(), random);
+
+	SplayTree<long> tree;
+	for (long key : present) tree.insert(key);
+
+	std::printf("batch     loop find   find_batch  (ms, 5 rounds)\n");
+	for (long size = 1000; size <= KEYS; size *= 10) {
+		std::vector<long> batch(size);
+		for (long & key : batch) key = random() % (2 * KEYS);
+
+		auto start = std::chrono::steady_clock::now();
+		size_t looped = 0;
+		for (int round = 0; round < 5; round++) {
+			for (long key : batch) looped += tree.find(key).has();
+		}
+		double loop = milliseconds(start);
+
+		start = std::chrono::steady_clock::now();
+		size_t batched = 0;
+		for (int round = 0; round < 5; round++) {
+			batched += tree.find_batch(batch).size();
+		}
+		double batchTime = milliseconds(start);
+
+		// find_batch drops repeats, so the counts differ when batch has any.
+		std::printf("%7ld  %10.1f  %11.1f  (%zu / %zu hits)\n", size, loop, batchTime, looped, batched);
+	}
+
+	std::vector<long> added(KEYS / 2);
+	for (long & key : added) key = (random() % (2 * KEYS)) | 1;
+	SplayTree<long> other;
+	for (long key : present) other.insert(key);
+
+	auto start = std::chrono::steady_clock::now();
+	for (long key : added) tree.insert(key);
+	double loop = milliseconds(start);
+	start = std::chrono::steady_clock::now();
+	other.insert_batch(added);
+	double batchTime = milliseconds(start);
+	std::printf("insert %ld: loop %.1f ms, insert_batch %.1f ms\n", KEYS / 2, loop, batchTime);
+	return 0;
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <limits>
+
+#include "redblack_tree.hpp"
+
+// Monoids for AggregateTree. A monoid names its summary type, an identity,
+// how to measure one element and an associative combine:
+//
+//   struct Weight {
+//       typedef long value_type;
+//       static value_type identity() { return 0; }
+//       static value_type lift(const Order & order) { return order.weight; }
+//       static value_type combine(value_type a, value_type b) { return a + b; }
+//   };
+//
+// combine need not be commutative; summaries always combine in key order.
+
+template <class T>
+struct SumMonoid {
+	typedef T value_type;
+	static T identity() { return T(); }
+	static T lift(const T & element) { return element; }
+	static T combine(const T & a, const T & b) { return a + b; }
+};
+
+template <class T>
+struct MinMonoid {
+	typedef T value_type;
+	static T identity() { return std::numeric_limits<T>::max(); }
+	static T lift(const T & element) { return element; }
+	static T combine(const T & a, const T & b) { return b < a ? b : a; }
+};
+
+template <class T>
+struct MaxMonoid {
+	typedef T value_type;
+	static T identity() { return std::numeric_limits<T>::lowest(); }
+	static T lift(const T & element) { return element; }
+	static T combine(const T & a, const T & b) { return a < b ? b : a; }
+};
+
+template <class T, class M>
+class AggregateTree;
+
+template <class T, class M>
+class AggregateNode : public RedBlackHook<AggregateNode<T, M>> {
+	friend class AggregateTree<T, M>;
+	friend class RedBlackBase<AggregateNode<T, M>>;
+public:
+
+protected:
+
+	typedef typename M::value_type Summary;
+
+	static const bool augmented = true;
+
+	T element;
+	// M-summary of every element in this subtree, in order.
+	Summary summary;
+
+	AggregateNode(const T & element) : element(element), summary(M::lift(element)) {
+	}
+
+	static Summary summary_of(AggregateNode *node) {
+		return node == nullptr ? M::identity() : node->summary;
+	}
+
+	void augment() {
+		this->summary = M::combine(summary_of(this->left),
+			M::combine(M::lift(this->element), summary_of(this->right)));
+	}
+
+private:
+
+};
+
+// Red-black tree that keeps an M-summary of every subtree, so the summary
+// of any key range comes back in O(log n) instead of a scan.
+template <class T, class M>
+class AggregateTree : public AbstractTree<T>, protected RedBlackBase<AggregateNode<T, M>> {
+public:
+	typedef AggregateNode<T, M> NodeType;
+	typedef typename M::value_type Summary;
+
+	AggregateTree() {
+	}
+
+	AggregateTree(const AggregateTree &) = delete;
+	AggregateTree & operator=(const AggregateTree &) = delete;
+
+	~AggregateTree() {
+		clear();
+	}
+
+	bool empty() const override {
+		return this->root == nullptr;
+	}
+
+	void clear() override {
+		this->drain([](NodeType *node) { delete node; });
+	}
+
+	Optional<T> find(const T & element) override {
+		NodeType* node = this->find(this->root, element);
+		if (node == nullptr) return Optional<T>();
+
+		return Optional<T>(node->element);
+	}
+
+	void insert(const T & element) override {
+		NodeType* parent = nullptr;
+		NodeType* node = this->root;
+		while (node != nullptr) {
+			parent = node;
+			if (element < node->element) node = node->left;
+			else if (node->element < element) node = node->right;
+			else return;
+		}
+
+		this->link(new NodeType(element), parent, parent != nullptr && element < parent->element);
+	}
+
+	void remove(const T & element) override {
+		NodeType* node = this->find(this->root, element);
+		if (node == nullptr) return;
+
+		this->erase(node);
+		delete node;
+	}
+
+	// Summary of every element.
+	Summary aggregate() const {
+		return NodeType::summary_of(this->root);
+	}
+
+	// Summary of the elements x with lo <= x <= hi, combined in order.
+	Summary aggregate(const T & lo, const T & hi) const {
+		// Find the highest node inside the range; the range splits there.
+		NodeType* split = this->root;
+		while (split != nullptr) {
+			if (split->element < lo) split = split->right;
+			else if (hi < split->element) split = split->left;
+			else break;
+		}
+		if (split == nullptr) return M::identity();
+
+		// Elements >= lo in the left subtree, gathered right to left.
+		Summary left = M::identity();
+		for (NodeType* node = split->left; node != nullptr; ) {
+			if (node->element < lo) {
+				node = node->right;
+			} else {
+				left = M::combine(M::lift(node->element), M::combine(NodeType::summary_of(node->right), left));
+				node = node->left;
+			}
+		}
+
+		// Elements <= hi in the right subtree, gathered left to right.
+		Summary right = M::identity();
+		for (NodeType* node = split->right; node != nullptr; ) {
+			if (hi < node->element) {
+				node = node->left;
+			} else {
+				right = M::combine(right, M::combine(NodeType::summary_of(node->left), M::lift(node->element)));
+				node = node->right;
+			}
+		}
+
+		return M::combine(left, M::combine(M::lift(split->element), right));
+	}
+
+protected:
+
+	NodeType* find(NodeType *root, const T & element) const {
+		while (root != nullptr) {
+			if (element < root->element) root = root->left;
+			else if (root->element < element) root = root->right;
+			else return root;
+		}
+		return nullptr;
+	}
+
+private:
+
+};
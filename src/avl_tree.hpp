@@ -17,10 +17,14 @@ protected:
 	T element;
 	AvlNode *left;
 	AvlNode *right;
+	AvlNode *parent;
 	int height;
 
 	AvlNode(const T & theElement, AvlNode *lt = nullptr, AvlNode *rt = nullptr, int h = 0)
-		: element(theElement), left(lt), right(rt), height(h) { }
+		: element(theElement), left(lt), right(rt), parent(nullptr), height(h) {
+		if (lt != nullptr) lt->parent = this;
+		if (rt != nullptr) rt->parent = this;
+	}
 
 private:
 
@@ -32,6 +36,7 @@ private:
 //
 // ******************PUBLIC OPERATIONS*********************
 // void insert( x )       --> Insert x
+// Position insert( h, x ) --> Insert x next to hint h if it belongs there
 // void remove( x )       --> Remove x
 // Comparable find( x )   --> Return item that matches x
 // Comparable findMin( )  --> Return smallest item
@@ -43,17 +48,25 @@ private:
 template <class T>
 class AvlTree : public AbstractTree<T> {
 public:
+	// Handle to a stored element, valid until that element is removed.
+	typedef const AvlNode<T>* Position;
 
 	AvlTree() :
 		root(nullptr),
+		leftmost(nullptr),
+		rightmost(nullptr),
 		size(0) { }
 
 	explicit AvlTree(const T & notFound) :
 		root(nullptr),
+		leftmost(nullptr),
+		rightmost(nullptr),
 		size(0) { }
 
 	AvlTree(const AvlTree & rhs) :
 		root(nullptr),
+		leftmost(nullptr),
+		rightmost(nullptr),
 		size(rhs.size) {
 		*this = rhs;
 	}
@@ -87,20 +100,81 @@ public:
 
 	void clear() override {
 		clear(root);
+		leftmost = rightmost = nullptr;
 	}
 
 	void insert(const T & x) override {
 		root = insert(x, root);
+		root->parent = nullptr;
+		if (leftmost == nullptr || x < leftmost->element) leftmost = findMin(root);
+		if (rightmost == nullptr || rightmost->element < x) rightmost = findMax(root);
+	}
+
+	// Inserts x using hint, typically the position returned by the previous
+	// insert. When x belongs right next to hint it is linked there and the
+	// tree is rebalanced upwards from it, so nearly sorted input costs
+	// amortized O(1) per element plus rebalancing. Returns the position of x.
+	Position insert(Position hint, const T & x) {
+		AvlNode<T>* node = const_cast<AvlNode<T>*>(hint);
+		AvlNode<T>* parent = nullptr;
+		bool asLeft = false;
+		if (node != nullptr) {
+			if (node->element < x) {
+				AvlNode<T>* next = node == rightmost ? nullptr : successor(node);
+				if (next == nullptr || x < next->element) {
+					if (node->right == nullptr) {
+						parent = node;
+					} else {
+						parent = next;
+						asLeft = true;
+					}
+				}
+			} else if (x < node->element) {
+				AvlNode<T>* prev = node == leftmost ? nullptr : predecessor(node);
+				if (prev == nullptr || prev->element < x) {
+					if (node->left == nullptr) {
+						parent = node;
+						asLeft = true;
+					} else {
+						parent = prev;
+					}
+				}
+			} else {
+				return node;
+			}
+		}
+		if (parent == nullptr) {
+			insert(x);
+			return find(x, root);
+		}
+
+		node = new AvlNode<T>(x);
+		node->parent = parent;
+		if (asLeft) parent->left = node;
+		else parent->right = node;
+		size++;
+		if (asLeft && parent == leftmost) leftmost = node;
+		if (!asLeft && parent == rightmost) rightmost = node;
+		rebalance_up(parent);
+		return node;
 	}
 
 	void remove(const T & x) override {
+		bool first = leftmost != nullptr && !(leftmost->element < x);
+		bool last = rightmost != nullptr && !(x < rightmost->element);
 		root = remove(x, root);
+		if (root != nullptr) root->parent = nullptr;
+		if (first) leftmost = findMin(root);
+		if (last) rightmost = findMax(root);
 	}
 
 	const AvlTree & operator=(const AvlTree & rhs) {
 		if (this != &rhs) {
 			clear();
 			root = clone(rhs.root);
+			size = rhs.size;
+			leftmost = findMin(root);
+			rightmost = findMax(root);
 		}
 		return *this;
 	}
@@ -114,6 +188,9 @@ public:
 protected:
 
 	AvlNode<T> *root;
+	// Smallest and largest nodes, so hints at either end need no climb.
+	AvlNode<T> *leftmost;
+	AvlNode<T> *rightmost;
 	
 	int size;
 
@@ -135,7 +212,7 @@ protected:
 			t->right = insert(x, t->right);
 		}
 		else {
-			return nullptr;
+			return t;
 		}
 		balance(t);
 		return t;
@@ -184,6 +261,18 @@ protected:
 		return t;
 	}
 	
+	AvlNode<T> * successor(AvlNode<T> *t) const {
+		if (t->right != nullptr) return findMin(t->right);
+		while (t->parent != nullptr && t == t->parent->right) t = t->parent;
+		return t->parent;
+	}
+
+	AvlNode<T> * predecessor(AvlNode<T> *t) const {
+		if (t->left != nullptr) return findMax(t->left);
+		while (t->parent != nullptr && t == t->parent->left) t = t->parent;
+		return t->parent;
+	}
+
 	AvlNode<T> * find(const T & x, AvlNode<T> *t) const {
 
 		while (t != nullptr) {
@@ -255,10 +344,28 @@ private:
 		return t == nullptr ? -1 : t->height;
 	}
 
+	// Every change of shape ends in fixheight on the nodes whose children
+	// changed, so it also points those children back at their parent.
 	void fixheight(AvlNode<T> *t) {
 		int h1 = height(t->left);
 		int h2 = height(t->right);
 		t->height = max(h1, h2) + 1;
+		if (t->left != nullptr) t->left->parent = t;
+		if (t->right != nullptr) t->right->parent = t;
+	}
+
+	// Rebalances from t up to the root after a leaf was linked below t,
+	// stopping as soon as a subtree is back to its old height.
+	void rebalance_up(AvlNode<T> *t) {
+		while (t != nullptr) {
+			AvlNode<T>* parent = t->parent;
+			AvlNode<T>*& link = parent == nullptr ? root : (parent->left == t ? parent->left : parent->right);
+			int old = t->height;
+			balance(link);
+			link->parent = parent;
+			if (link->height == old) return;
+			t = parent;
+		}
 	}
 
 	AvlNode<T>* balance(AvlNode<T> * & n) {
@@ -322,4 +429,4 @@ private:
 		rotate_l(node);
 	}
 
-};
\ No newline at end of file
+};
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Epoch-based reclamation for structures that are read without locks.
+//
+// Every access to shared nodes happens inside a Guard. A node that has been
+// unlinked is handed to Guard::retire() instead of being deleted, and is
+// freed once every guard that could still see it has been left: the global
+// epoch must have moved on twice since the retirement, and it only moves
+// when no guard is pinned to an older epoch.
+//
+//   EpochReclaimer::Guard guard(reclaimer);
+//   ... read or unlink nodes ...
+//   guard.retire(node);
+class EpochReclaimer {
+public:
+
+	// Guards that can be open at once; further ones wait for a free slot.
+	static const int SLOTS = 128;
+	// Retired nodes a slot collects before it tries to free some. When
+	// guards hold the epoch back, the slot waits until what is left has
+	// doubled before it scans again, so a stalled reader cannot make every
+	// retire() rescan a growing list.
+	static const size_t COLLECT_THRESHOLD = 64;
+
+	class Guard {
+	public:
+
+		explicit Guard(EpochReclaimer & owner) : owner(owner), slot(owner.enter()) {
+		}
+
+		Guard(const Guard &) = delete;
+		Guard & operator=(const Guard &) = delete;
+
+		~Guard() {
+			owner.leave(slot);
+		}
+
+		template <class P>
+		void retire(P *pointer) {
+			owner.retire(slot, pointer, &EpochReclaimer::destroy<P>);
+		}
+
+		void retire(void *pointer, void (*dispose)(void *)) {
+			owner.retire(slot, pointer, dispose);
+		}
+
+	private:
+
+		EpochReclaimer & owner;
+		int slot;
+	};
+
+	EpochReclaimer() : epoch(1) {
+		for (int i = 0; i < SLOTS; i++) slots[i].state.store(0, std::memory_order_relaxed);
+	}
+
+	EpochReclaimer(const EpochReclaimer &) = delete;
+	EpochReclaimer & operator=(const EpochReclaimer &) = delete;
+
+	// No guard may be open any more.
+	~EpochReclaimer() {
+		for (int i = 0; i < SLOTS; i++) {
+			for (Retired & retired : slots[i].limbo) retired.dispose(retired.pointer);
+		}
+	}
+
+protected:
+
+	struct Retired {
+		void *pointer;
+		void (*dispose)(void *);
+		uint64_t epoch;
+	};
+
+	// state is 0 while the slot is free, otherwise (epoch << 1) | 1 for the
+	// epoch its guard is pinned to. limbo and collect_at are only touched by
+	// the slot owner.
+	struct alignas(64) Slot {
+		std::atomic<uint64_t> state;
+		std::vector<Retired> limbo;
+		size_t collect_at = COLLECT_THRESHOLD;
+	};
+
+	std::atomic<uint64_t> epoch;
+	Slot slots[SLOTS];
+
+	template <class P>
+	static void destroy(void *pointer) {
+		delete static_cast<P *>(pointer);
+	}
+
+	int enter() {
+		static thread_local unsigned hint = unsigned(std::hash<std::thread::id>()(std::this_thread::get_id()));
+		for (unsigned i = hint;; i++) {
+			Slot & slot = slots[i % SLOTS];
+			uint64_t current = epoch.load();
+			uint64_t expected = 0;
+			if (slot.state.load(std::memory_order_relaxed) == 0
+					&& slot.state.compare_exchange_strong(expected, (current << 1) | 1)) {
+				// Re-announce until the announcement is known to have landed
+				// before any later epoch change.
+				for (uint64_t now = epoch.load(); now != current; now = epoch.load()) {
+					current = now;
+					slot.state.store((current << 1) | 1);
+				}
+				hint = i % SLOTS;
+				return int(i % SLOTS);
+			}
+			if (i % SLOTS == (hint + SLOTS - 1) % SLOTS) std::this_thread::yield();
+		}
+	}
+
+	void leave(int slot) {
+		slots[slot].state.store(0, std::memory_order_release);
+	}
+
+	void retire(int slot, void *pointer, void (*dispose)(void *)) {
+		std::vector<Retired> & limbo = slots[slot].limbo;
+		limbo.push_back(Retired{ pointer, dispose, epoch.load() });
+		if (limbo.size() < slots[slot].collect_at) return;
+
+		try_advance();
+		uint64_t now = epoch.load();
+		for (size_t i = 0; i < limbo.size(); ) {
+			if (limbo[i].epoch + 2 <= now) {
+				limbo[i].dispose(limbo[i].pointer);
+				limbo[i] = limbo.back();
+				limbo.pop_back();
+			} else {
+				i++;
+			}
+		}
+		slots[slot].collect_at = limbo.size() < COLLECT_THRESHOLD / 2 ? COLLECT_THRESHOLD : 2 * limbo.size();
+	}
+
+	void try_advance() {
+		uint64_t current = epoch.load();
+		for (int i = 0; i < SLOTS; i++) {
+			uint64_t state = slots[i].state.load();
+			if (state != 0 && (state >> 1) != current) return;
+		}
+		epoch.compare_exchange_strong(current, current + 1);
+	}
+
+private:
+
+};
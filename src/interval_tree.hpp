@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "redblack_tree.hpp"
+
+// Closed interval [low, high]. Intervals order by low, then high.
+template <class T>
+struct Interval {
+	T low;
+	T high;
+
+	Interval() : low(), high() { }
+	Interval(const T & low, const T & high) : low(low), high(high) { }
+
+	bool contains(const T & point) const {
+		return !(point < low) && !(high < point);
+	}
+
+	bool overlaps(const Interval & other) const {
+		return !(high < other.low) && !(other.high < low);
+	}
+};
+
+template <class T>
+bool operator<(const Interval<T> & a, const Interval<T> & b) {
+	return a.low < b.low || (!(b.low < a.low) && a.high < b.high);
+}
+
+template <class T>
+bool operator==(const Interval<T> & a, const Interval<T> & b) {
+	return !(a < b) && !(b < a);
+}
+
+template <class T>
+std::ostream & operator<<(std::ostream & stream, const Interval<T> & interval) {
+	return stream << "[" << interval.low << ", " << interval.high << "]";
+}
+
+template <class T>
+class IntervalTree;
+
+template <class T>
+class IntervalNode : public RedBlackHook<IntervalNode<T>> {
+	friend class IntervalTree<T>;
+	friend class RedBlackBase<IntervalNode<T>>;
+public:
+
+protected:
+
+	static const bool augmented = true;
+
+	Interval<T> element;
+	// Largest high endpoint in this subtree.
+	T max;
+
+	IntervalNode(const Interval<T> & element) : element(element), max(element.high) {
+	}
+
+	void augment() {
+		this->max = this->element.high;
+		if (this->left != nullptr && this->max < this->left->max) this->max = this->left->max;
+		if (this->right != nullptr && this->max < this->right->max) this->max = this->right->max;
+	}
+
+private:
+
+};
+
+// Red-black tree of intervals where every node also keeps the largest high
+// endpoint below it, so stabbing and overlap queries skip whole subtrees.
+// A query that reports k intervals costs O(min(n, k log n)); the max alone
+// cannot bound it by O(log n + k).
+template <class T>
+class IntervalTree : public AbstractTree<Interval<T>>, protected RedBlackBase<IntervalNode<T>> {
+public:
+
+	IntervalTree() {
+	}
+
+	IntervalTree(const IntervalTree &) = delete;
+	IntervalTree & operator=(const IntervalTree &) = delete;
+
+	~IntervalTree() {
+		clear();
+	}
+
+	bool empty() const override {
+		return this->root == nullptr;
+	}
+
+	void clear() override {
+		this->drain([](IntervalNode<T> *node) { delete node; });
+	}
+
+	Optional<Interval<T>> find(const Interval<T> & element) override {
+		IntervalNode<T>* node = this->find(this->root, element);
+		if (node == nullptr) return Optional<Interval<T>>();
+
+		return Optional<Interval<T>>(node->element);
+	}
+
+	void insert(const Interval<T> & element) override {
+		IntervalNode<T>* parent = nullptr;
+		IntervalNode<T>* node = this->root;
+		while (node != nullptr) {
+			parent = node;
+			if (element < node->element) node = node->left;
+			else if (node->element < element) node = node->right;
+			else return;
+		}
+
+		this->link(new IntervalNode<T>(element), parent, parent != nullptr && element < parent->element);
+	}
+
+	void remove(const Interval<T> & element) override {
+		IntervalNode<T>* node = this->find(this->root, element);
+		if (node == nullptr) return;
+
+		this->erase(node);
+		delete node;
+	}
+
+	// Calls visit(interval) for every stored interval containing point.
+	template <class F>
+	void stab(const T & point, F visit) const {
+		this->overlaps(Interval<T>(point, point), visit);
+	}
+
+	// Calls visit(interval) for every stored interval overlapping query, in
+	// order.
+	template <class F>
+	void overlaps(const Interval<T> & query, F visit) const {
+		this->overlaps(this->root, query, visit);
+	}
+
+	// Like overlaps(), but spreads the enumeration over up to threads threads.
+	// visit must be safe to call concurrently, and order is not kept. The
+	// tree must not be modified until the call returns.
+	template <class F>
+	void overlaps_parallel(const Interval<T> & query, F visit, unsigned threads) const {
+		if (threads <= 1) {
+			this->overlaps(query, visit);
+			return;
+		}
+
+		// Peel the top few levels off here; what is left below them are
+		// disjoint subtrees that can be searched independently.
+		int depth = 2;
+		for (unsigned n = threads; n > 1; n >>= 1) depth++;
+		std::vector<IntervalNode<T>*> subtrees;
+		this->split(this->root, query, visit, depth, subtrees);
+
+		std::atomic<size_t> next(0);
+		auto worker = [&]() {
+			for (size_t i = next++; i < subtrees.size(); i = next++) {
+				this->overlaps(subtrees[i], query, visit);
+			}
+		};
+		std::vector<std::thread> pool;
+		for (unsigned i = 1; i < threads && i < subtrees.size(); i++) {
+			pool.emplace_back(worker);
+		}
+		worker();
+		for (std::thread & thread : pool) thread.join();
+	}
+
+	void print(std::ostream & stream) const override {
+		for (IntervalNode<T>* node = this->first(); node != nullptr; node = this->next(node)) {
+			stream << node->element << std::endl;
+		}
+	}
+
+protected:
+
+	IntervalNode<T>* find(IntervalNode<T> *root, const Interval<T> & element) const {
+		while (root != nullptr) {
+			if (element < root->element) root = root->left;
+			else if (root->element < element) root = root->right;
+			else return root;
+		}
+		return nullptr;
+	}
+
+	template <class F>
+	void overlaps(IntervalNode<T> *node, const Interval<T> & query, F & visit) const {
+		// Nothing below ends at or after query.low.
+		if (node == nullptr || node->max < query.low) return;
+
+		this->overlaps(node->left, query, visit);
+		// Everything from here rightwards starts after query.high.
+		if (query.high < node->element.low) return;
+		if (!(node->element.high < query.low)) visit(node->element);
+		this->overlaps(node->right, query, visit);
+	}
+
+	template <class F>
+	void split(IntervalNode<T> *node, const Interval<T> & query, F & visit, int depth, std::vector<IntervalNode<T>*> & subtrees) const {
+		if (node == nullptr || node->max < query.low) return;
+		if (depth == 0) {
+			subtrees.push_back(node);
+			return;
+		}
+
+		this->split(node->left, query, visit, depth - 1, subtrees);
+		if (query.high < node->element.low) return;
+		if (!(node->element.high < query.low)) visit(node->element);
+		this->split(node->right, query, visit, depth - 1, subtrees);
+	}
+
+private:
+
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Fixed-size node storage owned by one container. Slots are carved out of
+// chunks that grow geometrically; a released slot goes on a free list and
+// is handed out again before any new chunk is touched, so steady churn does
+// not allocate. Dropping the pool frees every chunk at once without visiting
+// the nodes, so callers only need to walk their nodes when N has a
+// destructor that matters.
+//
+// Not synchronized: a pool belongs to a single container, and independent
+// containers share nothing.
+template <class N>
+class NodePool {
+public:
+
+	static const size_t FIRST_CHUNK = 64;
+	static const size_t MAX_CHUNK = 1 << 16;
+
+	NodePool() : chunks(nullptr), free(nullptr), next(nullptr), end(nullptr), chunkSize(FIRST_CHUNK) {
+	}
+
+	NodePool(const NodePool &) = delete;
+	NodePool & operator=(const NodePool &) = delete;
+
+	~NodePool() {
+		release();
+	}
+
+	// Raw storage for one N; construct it with placement new.
+	void* allocate() {
+		if (free != nullptr) {
+			Slot* slot = free;
+			free = slot->next;
+			return slot;
+		}
+		if (next == end) grow();
+		return next++;
+	}
+
+	// Takes back storage whose N has already been destroyed.
+	void deallocate(void *pointer) {
+		Slot* slot = static_cast<Slot*>(pointer);
+		slot->next = free;
+		free = slot;
+	}
+
+	// Frees every chunk. Every N must already be destroyed or trivially
+	// destructible.
+	void release() {
+		while (chunks != nullptr) {
+			Chunk* chunk = chunks;
+			chunks = chunk->next;
+			::operator delete(chunk);
+		}
+		free = next = end = nullptr;
+		chunkSize = FIRST_CHUNK;
+	}
+
+protected:
+
+	union Slot {
+		Slot *next;
+		alignas(N) unsigned char storage[sizeof(N)];
+	};
+
+	struct Chunk {
+		Chunk *next;
+	};
+
+	// Chunk headers are padded to a slot so the slots after them stay aligned.
+	static const size_t HEADER = (sizeof(Chunk) + sizeof(Slot) - 1) / sizeof(Slot);
+
+	Chunk *chunks;
+	Slot *free;
+	// Unused tail of the newest chunk.
+	Slot *next;
+	Slot *end;
+	size_t chunkSize;
+
+	void grow() {
+		Slot* slots = static_cast<Slot*>(::operator new((HEADER + chunkSize) * sizeof(Slot)));
+		Chunk* chunk = reinterpret_cast<Chunk*>(slots);
+		chunk->next = chunks;
+		chunks = chunk;
+		next = slots + HEADER;
+		end = next + chunkSize;
+		if (chunkSize < MAX_CHUNK) chunkSize *= 2;
+	}
+
+private:
+
+};
+
+// Variable-size node storage owned by one container. Requests are rounded
+// up to ALIGN bytes (Align, but at least a pointer) and bumped out of
+// chunks; released blocks go on a free list for their rounded size and are
+// reused for requests of that size first. Like NodePool, dropping the arena
+// frees every chunk at once.
+template <size_t Align = alignof(std::max_align_t)>
+class NodeArena {
+public:
+
+	static const size_t ALIGN = Align < sizeof(void*) ? sizeof(void*) : Align;
+	static const size_t CHUNK = 64 * 1024;
+
+	static_assert(Align <= alignof(std::max_align_t), "chunks are only aligned to max_align_t");
+
+	NodeArena() : chunks(nullptr), next(nullptr), end(nullptr) {
+	}
+
+	NodeArena(const NodeArena &) = delete;
+	NodeArena & operator=(const NodeArena &) = delete;
+
+	~NodeArena() {
+		release();
+	}
+
+	void* allocate(size_t bytes) {
+		size_t units = unitsOf(bytes);
+		if (units < free.size() && free[units] != nullptr) {
+			Block* block = free[units];
+			free[units] = block->next;
+			return block;
+		}
+		bytes = units * ALIGN;
+		if (size_t(end - next) < bytes) grow(bytes);
+		void* pointer = next;
+		next += bytes;
+		return pointer;
+	}
+
+	// Takes back a block from allocate(bytes) whose contents are destroyed.
+	void deallocate(void *pointer, size_t bytes) {
+		size_t units = unitsOf(bytes);
+		if (units >= free.size()) free.resize(units + 1, nullptr);
+		Block* block = static_cast<Block*>(pointer);
+		block->next = free[units];
+		free[units] = block;
+	}
+
+	// Frees every chunk. Everything allocated must already be destroyed or
+	// trivially destructible.
+	void release() {
+		while (chunks != nullptr) {
+			Block* chunk = chunks;
+			chunks = chunk->next;
+			::operator delete(chunk);
+		}
+		free.clear();
+		next = end = nullptr;
+	}
+
+	// Takes over every chunk and free block of other, which is left empty, so
+	// whatever other handed out now belongs to this arena. The unused end of
+	// other's current chunk is given up.
+	void adopt(NodeArena & other) {
+		if (&other == this) return;
+		while (other.chunks != nullptr) {
+			Block* chunk = other.chunks;
+			other.chunks = chunk->next;
+			chunk->next = chunks;
+			chunks = chunk;
+		}
+		if (other.free.size() > free.size()) free.resize(other.free.size(), nullptr);
+		for (size_t units = 0; units < other.free.size(); units++) {
+			while (other.free[units] != nullptr) {
+				Block* block = other.free[units];
+				other.free[units] = block->next;
+				block->next = free[units];
+				free[units] = block;
+			}
+		}
+		other.free.clear();
+		other.next = other.end = nullptr;
+	}
+
+protected:
+
+	struct Block {
+		Block *next;
+	};
+
+	// Chunks are chained through their first ALIGN bytes.
+	Block *chunks;
+	char *next;
+	char *end;
+	// free[n] lists released blocks of n * ALIGN bytes.
+	std::vector<Block*> free;
+
+	static size_t unitsOf(size_t bytes) {
+		return bytes == 0 ? 1 : (bytes + ALIGN - 1) / ALIGN;
+	}
+
+	void grow(size_t bytes) {
+		size_t size = ALIGN + (bytes > CHUNK ? bytes : CHUNK);
+		char* memory = static_cast<char*>(::operator new(size));
+		Block* chunk = reinterpret_cast<Block*>(memory);
+		chunk->next = chunks;
+		chunks = chunk;
+		next = memory + ALIGN;
+		end = memory + size;
+	}
+
+private:
+
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "epoch.hpp"
+#include "redblack_tree.hpp"
+
+// Child link published to lock-free readers. The writer reads it plainly
+// and every store is a release, so a reader that follows it with acquire()
+// sees a fully built node.
+template <class N>
+class RcuLink {
+public:
+
+	explicit RcuLink(N *value = nullptr) : pointer(value) {
+	}
+
+	RcuLink & operator=(N *value) {
+		pointer.store(value, std::memory_order_release);
+		return *this;
+	}
+
+	operator N*() const {
+		return pointer.load(std::memory_order_relaxed);
+	}
+
+	N* operator->() const {
+		return pointer.load(std::memory_order_relaxed);
+	}
+
+	N* acquire() const {
+		return pointer.load(std::memory_order_acquire);
+	}
+
+private:
+
+	std::atomic<N*> pointer;
+};
+
+template <class T>
+class ConcurrentRedBlackTree;
+
+template <class T>
+class ConcurrentRedBlackNode : public RedBlackHook<ConcurrentRedBlackNode<T>, RcuLink<ConcurrentRedBlackNode<T>>> {
+	friend class ConcurrentRedBlackTree<T>;
+public:
+
+protected:
+
+	const T element;
+
+	ConcurrentRedBlackNode(const T & element) : element(element) {
+	}
+
+private:
+
+};
+
+// Red-black tree with one writer and any number of lock-free readers.
+//
+// insert() and remove() must only ever be called from one thread at a time.
+// find() and for_each() may run on any thread concurrently with them and
+// never take a lock or write shared memory except their epoch slot.
+//
+// Rotations only ever store child links in an order that keeps the tree
+// acyclic, so a reader racing with a rotation always terminates but may
+// miss a key that was moved past it. Writers bump a sequence count around
+// every change, and a reader that misses while the count moved searches
+// again. Unlinked nodes are retired through epochs, so a reader never
+// touches freed memory.
+template <class T>
+class ConcurrentRedBlackTree : public AbstractTree<T>, protected RedBlackBase<ConcurrentRedBlackNode<T>, RcuLink<ConcurrentRedBlackNode<T>>> {
+public:
+	typedef ConcurrentRedBlackNode<T> NodeType;
+
+	ConcurrentRedBlackTree() : sequence(0) {
+	}
+
+	ConcurrentRedBlackTree(const ConcurrentRedBlackTree &) = delete;
+	ConcurrentRedBlackTree & operator=(const ConcurrentRedBlackTree &) = delete;
+
+	// No reader or writer may still be running.
+	~ConcurrentRedBlackTree() {
+		this->drain([](NodeType *node) { delete node; });
+	}
+
+	bool empty() const override {
+		return this->root.acquire() == nullptr;
+	}
+
+	Optional<T> find(const T & element) override {
+		EpochReclaimer::Guard guard(reclaimer);
+		while (true) {
+			// A hit is always right, so only a miss has to wait for a
+			// quiet moment.
+			unsigned long begin = sequence.load(std::memory_order_acquire);
+			NodeType* node = this->root.acquire();
+			while (node != nullptr) {
+				if (element < node->element) node = node->left.acquire();
+				else if (node->element < element) node = node->right.acquire();
+				else return Optional<T>(node->element);
+			}
+			if (this->read_valid(begin)) return Optional<T>();
+			std::this_thread::yield();
+		}
+	}
+
+	// Calls visit(element) for the elements in order. Elements inserted or
+	// removed while it runs may or may not be seen; everything else is seen
+	// exactly once.
+	template <class F>
+	void for_each(F visit) const {
+		EpochReclaimer::Guard guard(reclaimer);
+		std::vector<NodeType*> stack;
+		const T* last = nullptr;
+		unsigned long begin = this->read_begin();
+		this->seek(stack, last);
+		while (true) {
+			if (!this->read_valid(begin)) {
+				// The path may be stale; pick it up again after the last
+				// element handed out.
+				begin = this->read_begin();
+				this->seek(stack, last);
+				continue;
+			}
+			if (stack.empty()) return;
+
+			NodeType* node = stack.back();
+			stack.pop_back();
+			visit(node->element);
+			last = &node->element;
+			for (NodeType* child = node->right.acquire(); child != nullptr; child = child->left.acquire()) {
+				stack.push_back(child);
+			}
+		}
+	}
+
+	// Writer only.
+	void insert(const T & element) override {
+		NodeType* parent = nullptr;
+		NodeType* node = this->root;
+		while (node != nullptr) {
+			parent = node;
+			if (element < node->element) node = node->left;
+			else if (node->element < element) node = node->right;
+			else return;
+		}
+
+		NodeType* fresh = new NodeType(element);
+		this->write_begin();
+		this->link(fresh, parent, parent != nullptr && element < parent->element);
+		this->write_end();
+	}
+
+	// Writer only.
+	void remove(const T & element) override {
+		NodeType* node = this->root;
+		while (node != nullptr) {
+			if (element < node->element) node = node->left;
+			else if (node->element < element) node = node->right;
+			else break;
+		}
+		if (node == nullptr) return;
+
+		EpochReclaimer::Guard guard(reclaimer);
+		this->write_begin();
+		this->erase(node);
+		this->write_end();
+		guard.retire(node);
+	}
+
+protected:
+
+	std::atomic<unsigned long> sequence;
+	mutable EpochReclaimer reclaimer;
+
+	void write_begin() {
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	void write_end() {
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Waits out a change in progress and returns the count to validate against.
+	unsigned long read_begin() const {
+		unsigned long begin = sequence.load(std::memory_order_acquire);
+		while (begin & 1) {
+			std::this_thread::yield();
+			begin = sequence.load(std::memory_order_acquire);
+		}
+		return begin;
+	}
+
+	// True when no change was in progress at begin and none started since.
+	bool read_valid(unsigned long begin) const {
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return (begin & 1) == 0 && sequence.load(std::memory_order_relaxed) == begin;
+	}
+
+	// Rebuilds the in-order stack for the elements after *last (or for all
+	// elements when last is nullptr).
+	void seek(std::vector<NodeType*> & stack, const T *last) const {
+		stack.clear();
+		NodeType* node = this->root.acquire();
+		while (node != nullptr) {
+			if (last != nullptr && !(*last < node->element)) {
+				node = node->right.acquire();
+			} else {
+				stack.push_back(node);
+				node = node->left.acquire();
+			}
+		}
+	}
+
+private:
+
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "redblack_tree.hpp"
+
+// Red-black tree over objects the caller owns. The object type N derives
+// publicly from RedBlackHook<N> and is ordered by operator<; the tree links
+// objects in place and never allocates, copies or frees them.
+//
+//   struct Connection : RedBlackHook<Connection> { ... };
+//   IntrusiveRedBlackTree<Connection> table;
+//   table.insert(conn);   // no allocation
+//   table.remove(conn);   // no search
+//
+// An object can be in at most one tree through a given hook, and must be
+// removed (or the tree cleared) before it is destroyed.
+
+template <class N>
+class IntrusiveRedBlackTree : protected RedBlackBase<N> {
+public:
+
+	IntrusiveRedBlackTree() : count(0) {
+	}
+
+	IntrusiveRedBlackTree(const IntrusiveRedBlackTree &) = delete;
+	IntrusiveRedBlackTree & operator=(const IntrusiveRedBlackTree &) = delete;
+
+	~IntrusiveRedBlackTree() {
+		clear();
+	}
+
+	bool empty() const {
+		return this->root == nullptr;
+	}
+
+	int size() const {
+		return count;
+	}
+
+	// True while object is linked into some tree. An unlinked hook is red with
+	// no parent, which a linked node never is (the root is always black).
+	static bool linked(const N & object) {
+		return object.parentColor != 1;
+	}
+
+	// Returns the linked object equal to key, or nullptr. K may be any type
+	// that compares against N with operator< both ways.
+	template <class K>
+	N* find(const K & key) const {
+		N* node = this->root;
+		while (node != nullptr) {
+			if (key < *node) node = node->left;
+			else if (*node < key) node = node->right;
+			else return node;
+		}
+		return nullptr;
+	}
+
+	// Links object into the tree. Returns false and leaves object untouched
+	// when an equal object is already linked.
+	bool insert(N & object) {
+		N* parent = nullptr;
+		N* node = this->root;
+		bool asLeft = false;
+		while (node != nullptr) {
+			parent = node;
+			if (object < *node) {
+				node = node->left;
+				asLeft = true;
+			} else if (*node < object) {
+				node = node->right;
+				asLeft = false;
+			} else {
+				return false;
+			}
+		}
+		this->link(&object, parent, asLeft);
+		count++;
+		return true;
+	}
+
+	// Unlinks a linked object without searching for it. Finding its
+	// successor and rebalancing still take O(log n) in the worst case.
+	void remove(N & object) {
+		this->erase(&object);
+		unhook(&object);
+		count--;
+	}
+
+	// Unlinks every object. Objects are not touched beyond their hooks.
+	void clear() {
+		this->drain(unhook);
+		count = 0;
+	}
+
+	N* first() const {
+		return RedBlackBase<N>::first();
+	}
+
+	N* last() const {
+		return RedBlackBase<N>::last();
+	}
+
+	static N* next(N & object) {
+		return RedBlackBase<N>::next(&object);
+	}
+
+	static N* prev(N & object) {
+		return RedBlackBase<N>::prev(&object);
+	}
+
+protected:
+
+	int count;
+
+	static void unhook(N *node) {
+		node->left = nullptr;
+		node->right = nullptr;
+		node->parentColor = 1;
+	}
+
+private:
+
+};
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <cstdint>
+
+#include "tree.hpp"
+
+// Red-black tree without parent pointers. Insert and remove remember the
+// search path on a stack and rebalance from it, so a node is only two
+// pointers plus the element; the color lives in the low bit of left.
+
+template <class T>
+class RedBlackPathTree;
+
+template <class T>
+class RedBlackPathNode {
+	friend class RedBlackPathTree<T>;
+public:
+
+protected:
+
+	T element;
+	uintptr_t leftColor;
+	RedBlackPathNode<T> *right;
+
+	RedBlackPathNode(const T & element) : element(element), leftColor(1), right(nullptr) {
+	}
+
+	RedBlackPathNode* left() const {
+		return reinterpret_cast<RedBlackPathNode*>(this->leftColor & ~uintptr_t(1));
+	}
+
+	bool isRed() const {
+		return (this->leftColor & 1) != 0;
+	}
+
+	void set_red(bool red) {
+		this->leftColor = (this->leftColor & ~uintptr_t(1)) | uintptr_t(red);
+	}
+
+	void recolor() {
+		this->leftColor ^= 1;
+	}
+
+	void set_left(RedBlackPathNode* left) {
+		this->leftColor = reinterpret_cast<uintptr_t>(left) | (this->leftColor & 1);
+	}
+
+	void set_right(RedBlackPathNode* right) {
+		this->right = right;
+	}
+
+private:
+
+};
+
+template <class T>
+class RedBlackPathTree : public AbstractTree<T> {
+public:
+
+	RedBlackPathTree() : root(nullptr) {
+	}
+
+	~RedBlackPathTree() {
+		clear();
+	}
+
+	bool empty() const override {
+		return root == nullptr;
+	}
+
+	void clear() override {
+		// Rotate left children up so the tree becomes a right spine that can
+		// be freed without a stack.
+		RedBlackPathNode<T>* node = root;
+		while (node != nullptr) {
+			RedBlackPathNode<T>* left = node->left();
+			if (left != nullptr) {
+				node->set_left(left->right);
+				left->set_right(node);
+				node = left;
+			} else {
+				RedBlackPathNode<T>* right = node->right;
+				delete node;
+				node = right;
+			}
+		}
+		root = nullptr;
+	}
+
+	Optional<T> find(const T & element) override {
+		RedBlackPathNode<T>* node = root;
+		while (node != nullptr) {
+			if (element < node->element) node = node->left();
+			else if (node->element < element) node = node->right;
+			else return Optional<T>(node->element);
+		}
+		return Optional<T>();
+	}
+
+	void insert(const T & element) override {
+		RedBlackPathNode<T>* path[MAX_HEIGHT];
+		int depth = 0;
+		RedBlackPathNode<T>* node = root;
+		while (node != nullptr) {
+			path[depth++] = node;
+			if (element < node->element) node = node->left();
+			else if (node->element < element) node = node->right;
+			else return;
+		}
+
+		node = new RedBlackPathNode<T>(element);
+		if (depth == 0) {
+			root = node;
+			root->set_red(false);
+			return;
+		}
+		if (element < path[depth - 1]->element) path[depth - 1]->set_left(node);
+		else path[depth - 1]->set_right(node);
+		path[depth] = node;
+
+		this->balance(path, depth);
+	}
+
+	void remove(const T & element) override {
+		RedBlackPathNode<T>* path[MAX_HEIGHT];
+		int depth = 0;
+		RedBlackPathNode<T>* node = root;
+		while (node != nullptr) {
+			if (element < node->element) {
+				path[depth++] = node;
+				node = node->left();
+			} else if (node->element < element) {
+				path[depth++] = node;
+				node = node->right;
+			} else {
+				break;
+			}
+		}
+		if (node == nullptr) return;
+
+		RedBlackPathNode<T>* parent = depth > 0 ? path[depth - 1] : nullptr;
+		RedBlackPathNode<T>* child;
+		bool removedRed;
+		if (node->left() == nullptr || node->right == nullptr) {
+			child = node->left() != nullptr ? node->left() : node->right;
+			removedRed = node->isRed();
+			this->replace(parent, node, child);
+		} else {
+			// Move the in-order successor into node's place, keeping the path
+			// in step with the tree.
+			int nodeDepth = depth;
+			path[depth++] = node;
+			RedBlackPathNode<T>* successor = node->right;
+			while (successor->left() != nullptr) {
+				path[depth++] = successor;
+				successor = successor->left();
+			}
+			child = successor->right;
+			removedRed = successor->isRed();
+			if (path[depth - 1] != node) {
+				path[depth - 1]->set_left(child);
+				successor->set_right(node->right);
+			}
+			successor->set_left(node->left());
+			successor->set_red(node->isRed());
+			this->replace(parent, node, successor);
+			path[nodeDepth] = successor;
+		}
+		delete node;
+
+		if (!removedRed) this->reheight(path, depth, child);
+	}
+
+protected:
+
+	// Enough for any red-black tree addressable in 64 bits, plus the slot
+	// reheight needs when a rotation pushes the current node down.
+	static const int MAX_HEIGHT = 130;
+
+	RedBlackPathNode<T>* root;
+
+private:
+
+	static bool is_red(RedBlackPathNode<T> *node) {
+		return node != nullptr && node->isRed();
+	}
+
+	void replace(RedBlackPathNode<T> *parent, RedBlackPathNode<T> *node, RedBlackPathNode<T> *with) {
+		if (parent == nullptr) root = with;
+		else if (parent->left() == node) parent->set_left(with);
+		else parent->set_right(with);
+	}
+
+	RedBlackPathNode<T>* rotate_l(RedBlackPathNode<T> *node) {
+		RedBlackPathNode<T>* child = node->right;
+		node->set_right(child->left());
+		child->set_left(node);
+		return child;
+	}
+
+	RedBlackPathNode<T>* rotate_r(RedBlackPathNode<T> *node) {
+		RedBlackPathNode<T>* child = node->left();
+		node->set_left(child->right);
+		child->set_right(node);
+		return child;
+	}
+
+	// path[0..depth] runs from the root to the red node just linked in.
+	void balance(RedBlackPathNode<T> **path, int depth) {
+		while (depth >= 2 && path[depth - 1]->isRed()) {
+			RedBlackPathNode<T>* node = path[depth];
+			RedBlackPathNode<T>* parent = path[depth - 1];
+			RedBlackPathNode<T>* grandParent = path[depth - 2];
+			RedBlackPathNode<T>* top;
+			if (parent == grandParent->left()) {
+				RedBlackPathNode<T>* uncle = grandParent->right;
+				if (is_red(uncle)) {
+					parent->recolor();
+					uncle->recolor();
+					grandParent->recolor();
+					depth -= 2;
+					continue;
+				}
+				if (node == parent->right) {
+					grandParent->set_left(this->rotate_l(parent));
+				}
+				grandParent->recolor();
+				top = this->rotate_r(grandParent);
+			} else {
+				RedBlackPathNode<T>* uncle = grandParent->left();
+				if (is_red(uncle)) {
+					parent->recolor();
+					uncle->recolor();
+					grandParent->recolor();
+					depth -= 2;
+					continue;
+				}
+				if (node == parent->left()) {
+					grandParent->set_right(this->rotate_r(parent));
+				}
+				grandParent->recolor();
+				top = this->rotate_l(grandParent);
+			}
+			top->set_red(false);
+			this->replace(depth >= 3 ? path[depth - 3] : nullptr, grandParent, top);
+			break;
+		}
+		root->set_red(false);
+	}
+
+	// path[0..depth-1] are the ancestors of node (possibly nullptr), which
+	// carries the black that was removed.
+	void reheight(RedBlackPathNode<T> **path, int depth, RedBlackPathNode<T> *node) {
+		while (depth > 0 && !is_red(node)) {
+			RedBlackPathNode<T>* parent = path[depth - 1];
+			RedBlackPathNode<T>* grandParent = depth >= 2 ? path[depth - 2] : nullptr;
+			if (node == parent->left()) {
+				RedBlackPathNode<T>* sibling = parent->right;
+				if (sibling->isRed()) {
+					sibling->recolor();
+					parent->recolor();
+					this->replace(grandParent, parent, this->rotate_l(parent));
+					grandParent = path[depth - 1] = sibling;
+					path[depth++] = parent;
+					sibling = parent->right;
+				}
+				if (!is_red(sibling->left()) && !is_red(sibling->right)) {
+					sibling->recolor();
+					node = parent;
+					depth--;
+					continue;
+				}
+				if (!is_red(sibling->right)) {
+					sibling->left()->recolor();
+					sibling->recolor();
+					sibling = this->rotate_r(sibling);
+					parent->set_right(sibling);
+				}
+				sibling->set_red(parent->isRed());
+				parent->set_red(false);
+				sibling->right->set_red(false);
+				this->replace(grandParent, parent, this->rotate_l(parent));
+			} else {
+				RedBlackPathNode<T>* sibling = parent->left();
+				if (sibling->isRed()) {
+					sibling->recolor();
+					parent->recolor();
+					this->replace(grandParent, parent, this->rotate_r(parent));
+					grandParent = path[depth - 1] = sibling;
+					path[depth++] = parent;
+					sibling = parent->left();
+				}
+				if (!is_red(sibling->left()) && !is_red(sibling->right)) {
+					sibling->recolor();
+					node = parent;
+					depth--;
+					continue;
+				}
+				if (!is_red(sibling->left())) {
+					sibling->right->recolor();
+					sibling->recolor();
+					sibling = this->rotate_l(sibling);
+					parent->set_left(sibling);
+				}
+				sibling->set_red(parent->isRed());
+				parent->set_red(false);
+				sibling->left()->set_red(false);
+				this->replace(grandParent, parent, this->rotate_r(parent));
+			}
+			return;
+		}
+		if (node != nullptr) node->set_red(false);
+	}
+
+};
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "redblack_tree.hpp"
+
+template <class T>
+class RelaxedRedBlackTree;
+
+template <class T>
+class RelaxedRedBlackNode : public RedBlackHook<RelaxedRedBlackNode<T>> {
+	friend class RelaxedRedBlackTree<T>;
+public:
+
+protected:
+
+	T element;
+	// Logically removed; unlinked by a later rebalance step.
+	bool removed;
+	// Sitting in the tree's list of nodes to unlink.
+	bool doomed;
+
+	RelaxedRedBlackNode(const T & element) : element(element), removed(false), doomed(false) {
+	}
+
+private:
+
+};
+
+// Red-black tree with relaxed (deferred) balance.
+//
+// insert() links the new node in red and only records it when that leaves
+// a red node under a red parent; remove() only marks the node. Neither
+// rotates. rebalance_step(budget) then repairs recorded violations and
+// unlinks marked nodes a bounded amount of work at a time, so update cost
+// stays flat during bursts and the tree converges back to red-black shape
+// once the steps catch up.
+//
+// Relaxed inserts keep every black height equal; the only violations are
+// red-red edges, each recorded by its lower node. Marked nodes are only
+// unlinked once no violation is left, when the tree is a valid red-black
+// tree again and the ordinary delete repair applies.
+template <class T>
+class RelaxedRedBlackTree : public AbstractTree<T>, protected RedBlackBase<RelaxedRedBlackNode<T>> {
+public:
+	typedef RelaxedRedBlackNode<T> NodeType;
+
+	RelaxedRedBlackTree() : count(0) {
+	}
+
+	RelaxedRedBlackTree(const RelaxedRedBlackTree &) = delete;
+	RelaxedRedBlackTree & operator=(const RelaxedRedBlackTree &) = delete;
+
+	~RelaxedRedBlackTree() {
+		clear();
+	}
+
+	bool empty() const override {
+		return count == 0;
+	}
+
+	int size() const {
+		return count;
+	}
+
+	void clear() override {
+		this->drain([](NodeType *node) { delete node; });
+		violations.clear();
+		doomed.clear();
+		count = 0;
+	}
+
+	Optional<T> find(const T & element) override {
+		NodeType* node = this->find(this->root, element);
+		if (node == nullptr || node->removed) return Optional<T>();
+
+		return Optional<T>(node->element);
+	}
+
+	void insert(const T & element) override {
+		NodeType* parent = nullptr;
+		NodeType* node = this->root;
+		while (node != nullptr) {
+			parent = node;
+			if (element < node->element) {
+				node = node->left;
+			} else if (node->element < element) {
+				node = node->right;
+			} else {
+				if (node->removed) {
+					node->removed = false;
+					count++;
+				}
+				return;
+			}
+		}
+
+		node = new NodeType(element);
+		this->attach(node, parent, parent != nullptr && element < parent->element);
+		if (parent == nullptr) node->set_red(false);
+		else if (parent->isRed()) violations.push_back(node);
+		count++;
+	}
+
+	void remove(const T & element) override {
+		NodeType* node = this->find(this->root, element);
+		if (node == nullptr || node->removed) return;
+
+		node->removed = true;
+		count--;
+		if (!node->doomed) {
+			node->doomed = true;
+			doomed.push_back(node);
+		}
+	}
+
+	// True when nothing is left for rebalance_step() to do.
+	bool balanced() const {
+		return violations.empty() && doomed.empty();
+	}
+
+	// Does at most budget units of deferred work, a unit being one recolor or
+	// rotation step or one unlink. Returns true once the tree is balanced.
+	bool rebalance_step(int budget) {
+		while (budget > 0 && !violations.empty()) {
+			NodeType* node = violations.front();
+			violations.pop_front();
+			budget -= this->repair(node, budget);
+		}
+		while (budget > 0 && violations.empty() && !doomed.empty()) {
+			NodeType* node = doomed.back();
+			doomed.pop_back();
+			node->doomed = false;
+			if (node->removed) {
+				this->erase(node);
+				delete node;
+			}
+			budget--;
+		}
+		return this->balanced();
+	}
+
+	void rebalance() {
+		while (!this->rebalance_step(1 << 20)) { }
+	}
+
+protected:
+
+	int count;
+	// Lower nodes of red-red edges still to repair, oldest first.
+	std::deque<NodeType*> violations;
+	std::vector<NodeType*> doomed;
+
+	NodeType* find(NodeType *root, const T & element) const {
+		while (root != nullptr) {
+			if (element < root->element) root = root->left;
+			else if (root->element < element) root = root->right;
+			else return root;
+		}
+		return nullptr;
+	}
+
+	// Repairs the red-red edge above node, spending at most budget units.
+	// Returns the units spent; whatever is left over goes back on the list.
+	int repair(NodeType *node, int budget) {
+		int spent = 0;
+		while (node->isRed() && this->is_red(node->parent())) {
+			if (spent == budget) {
+				violations.push_front(node);
+				return spent;
+			}
+			spent++;
+
+			// Work on the topmost edge of a red chain first so the
+			// grandparent is black, as the ordinary repair expects. The
+			// edges skipped over stay recorded.
+			NodeType* parent = node->parent();
+			if (this->is_red(parent->parent())) {
+				violations.push_back(node);
+				while (this->is_red(parent->parent())) {
+					node = parent;
+					parent = node->parent();
+				}
+			}
+			NodeType* grandParent = parent->parent();
+			if (grandParent == nullptr) {
+				parent->set_red(false);
+				continue;
+			}
+
+			if (parent == grandParent->left) {
+				NodeType* uncle = grandParent->right;
+				if (this->is_red(uncle)) {
+					parent->recolor();
+					uncle->recolor();
+					grandParent->recolor();
+					node = grandParent;
+					continue;
+				}
+				if (node == parent->right) {
+					this->rotate_l(parent);
+					parent = node;
+				}
+				parent->recolor();
+				grandParent->recolor();
+				this->rotate_r(grandParent);
+			} else {
+				NodeType* uncle = grandParent->left;
+				if (this->is_red(uncle)) {
+					parent->recolor();
+					uncle->recolor();
+					grandParent->recolor();
+					node = grandParent;
+					continue;
+				}
+				if (node == parent->left) {
+					this->rotate_r(parent);
+					parent = node;
+				}
+				parent->recolor();
+				grandParent->recolor();
+				this->rotate_l(grandParent);
+			}
+			break;
+		}
+		if (this->root != nullptr) this->root->set_red(false);
+		return spent == 0 ? 1 : spent;
+	}
+
+private:
+
+};
@@ -1,493 +1,490 @@
+#pragma once
+
+#include <cstdint>
 
 #include "tree.hpp"
 
 
+template <class N, class Link = N*>
+class RedBlackBase;
+
+template <class N>
+class IntrusiveRedBlackTree;
+
 template <class T>
 class RedBlackTree;
 
-template <class T>
-class RedBlackNode {
-	friend class RedBlackTree<T>;
+// Links a red-black tree keeps in each node. Any type becomes linkable by
+// deriving publicly from RedBlackHook<itself>; the member names below are
+// then taken. Link is the type of the child links: a plain pointer, or
+// anything that converts to and assigns from N* and supports ->.
+template <class N, class Link = N*>
+class RedBlackHook {
+	friend class RedBlackBase<N, Link>;
+	friend class IntrusiveRedBlackTree<N>;
 public:
 
+	RedBlackHook() : left(nullptr), right(nullptr), parentColor(1) {
+	}
+
 protected:
 
-	T element;
-	RedBlackNode<T> *left;
-	RedBlackNode<T> *right;
-	RedBlackNode<T> *parent;
-	bool isRed;
+	Link left;
+	Link right;
+	// Parent pointer with the color in its low bit (set means red). Nodes are
+	// pointer aligned, so that bit of a real address is always zero.
+	uintptr_t parentColor;
+
+	// Nodes that keep data about their whole subtree redeclare augmented as
+	// true and provide augment(), which recomputes that data from the node
+	// and its children. The tree calls it wherever a subtree changes shape.
+	static const bool augmented = false;
+
+	void augment() {
+	}
 
-	RedBlackNode(T element) : element(element), left(nullptr), right(nullptr), parent(nullptr), isRed(true) {
+	N* parent() const {
+		return reinterpret_cast<N*>(this->parentColor & ~uintptr_t(1));
+	}
+
+	void set_parent(N* parent) {
+		this->parentColor = reinterpret_cast<uintptr_t>(parent) | (this->parentColor & 1);
+	}
+
+	bool isRed() const {
+		return (this->parentColor & 1) != 0;
+	}
+
+	void set_red(bool red) {
+		this->parentColor = (this->parentColor & ~uintptr_t(1)) | uintptr_t(red);
 	}
 
 	void recolor() {
-		this->isRed = !this->isRed;
+		this->parentColor ^= 1;
 	}
 
-	void set_left(RedBlackNode* left) {
+	void set_left(N* left) {
 		this->left = left;
-		if (left != nullptr) left->parent = this;
+		if (left != nullptr) left->set_parent(static_cast<N*>(this));
 	}
 
-	void set_right(RedBlackNode* right) {
+	void set_right(N* right) {
 		this->right = right;
-		if (right != nullptr) right->parent = this;
+		if (right != nullptr) right->set_parent(static_cast<N*>(this));
 	}
 
-
 private:
 
 };
 
 template <class T>
-class RedBlackTree : public AbstractTree<T> {
+class RedBlackNode : public RedBlackHook<RedBlackNode<T>> {
+	friend class RedBlackTree<T>;
 public:
 
-	RedBlackTree() {
-		this->root = nullptr;
-	}
+protected:
 
-	bool empty() const override {
-		return root == nullptr;
+	T element;
+
+	RedBlackNode(T element) : element(element) {
 	}
 
-	Optional<T> find(const T & element) override {
-		if (this->empty()) return Optional<T>();
+private:
 
-		RedBlackNode<T>* node = this->find(root, element);
-		if (node == nullptr) return Optional<T>();
+};
 
-		return Optional<T>(node->element);
-	}
+// Rebalancing shared by every tree built from RedBlackHook nodes. It only
+// relinks nodes; allocation and key comparison are left to the tree. Link
+// matches the link type of the nodes' hook and is used for the root too.
+template <class N, class Link>
+class RedBlackBase {
+public:
 
-	void insert(const T & element) override {
-		if (this->empty()) {
-			this->root = new RedBlackNode<T>(element);
-			this->root->recolor();
-		} else {
-			this->insert(this->root, element);
-		}
-	}
+protected:
 
-	void remove(const T & element) override {
-		if (!this->empty()) this->remove(root, element);
+	Link root;
+
+	RedBlackBase() : root(nullptr) {
 	}
 
-protected:
+	N* first() const {
+		N* node = this->root;
+		if (node == nullptr) return nullptr;
+		while (node->left != nullptr) node = node->left;
+		return node;
+	}
 
-	RedBlackNode<T>* root;
+	N* last() const {
+		N* node = this->root;
+		if (node == nullptr) return nullptr;
+		while (node->right != nullptr) node = node->right;
+		return node;
+	}
 
+	static N* next(N* node) {
+		if (node->right != nullptr) {
+			node = node->right;
+			while (node->left != nullptr) node = node->left;
+			return node;
+		}
+		N* parent = node->parent();
+		while (parent != nullptr && node == parent->right) {
+			node = parent;
+			parent = node->parent();
+		}
+		return parent;
+	}
 
-	RedBlackNode<T>* find(RedBlackNode<T> *root, T element) const {
-		if (root->element == element) {
-			return root;
-		} else if (root->element > element) {
-			if (root->left == nullptr) {
-				return nullptr;
-			} else {
-				return this->find(root->left, element);
-			}
-		} else {
-			if (root->right == nullptr) {
-				return nullptr;
-			} else {
-				return this->find(root->right, element);
-			}
+	static N* prev(N* node) {
+		if (node->left != nullptr) {
+			node = node->left;
+			while (node->right != nullptr) node = node->right;
+			return node;
+		}
+		N* parent = node->parent();
+		while (parent != nullptr && node == parent->left) {
+			node = parent;
+			parent = node->parent();
 		}
+		return parent;
 	}
 
-	void insert(RedBlackNode<T> *root, T element) {
-		RedBlackNode<T>* insertedNode = nullptr;
-		if (root->element == element) {
-		} else if (root->element > element) {
-			if (root->left == nullptr) {
-				insertedNode = new RedBlackNode<T>(element);
-				root->set_left(insertedNode);
+	// Unlinks every node, children before parents, handing each to dispose
+	// once it is detached. Needs no stack.
+	template <class F>
+	void drain(F dispose) {
+		N* node = this->root;
+		while (node != nullptr) {
+			if (node->left != nullptr) {
+				node = node->left;
+			} else if (node->right != nullptr) {
+				node = node->right;
 			} else {
-				this->insert(root->left, element);
-			}
-		} else {
-			if (root->right == nullptr) {
-				insertedNode = new RedBlackNode<T>(element);
-				root->set_right(insertedNode);
-			} else {
-				this->insert(root->right, element);
-			}
-		}
-		if (insertedNode == nullptr) return;
-		this->balance(root);
-		insertedNode = nullptr;
-	}
-
-	void remove(RedBlackNode<T> *root, T element) {
-		if (root->element == element) {
-			RedBlackNode<T> *leftmostFromRight;
-			if (root->left == nullptr) leftmostFromRight = root->right;
-			else if (root->right == nullptr) leftmostFromRight = root->left;
-			else if (root->left->right == nullptr) leftmostFromRight = root->left;
-			else if (root->right->left == nullptr) leftmostFromRight = root->right;
-			else {
-				leftmostFromRight = root->right->left;
-				while (leftmostFromRight->left != nullptr) {
-					leftmostFromRight = leftmostFromRight->left;
+				N* parent = node->parent();
+				if (parent != nullptr) {
+					if (parent->left == node) parent->left = nullptr;
+					else parent->right = nullptr;
 				}
+				dispose(node);
+				node = parent;
 			}
-			if (leftmostFromRight == nullptr) {
-				if (root->left != nullptr) root->left->recolor();
-				else if (root->right != nullptr) root->right->recolor();
-				else if (!root->isRed) reheight(root);
-			} else {
-				if (leftmostFromRight->left != nullptr) leftmostFromRight->left->recolor();
-				else if (leftmostFromRight->right != nullptr) leftmostFromRight->right->recolor();
-				else if (!leftmostFromRight->isRed) reheight(leftmostFromRight);
-				if (leftmostFromRight != root->left && leftmostFromRight != root->right) leftmostFromRight->parent->set_left(leftmostFromRight->right);
-
-				if (leftmostFromRight != root->left && root->left != nullptr) leftmostFromRight->set_left(root->left);
-				if (leftmostFromRight != root->right && root->right != nullptr) leftmostFromRight->set_right(root->right);
-				if (root->isRed && !leftmostFromRight->isRed) leftmostFromRight->recolor();
-				if (!root->isRed && leftmostFromRight->isRed) leftmostFromRight->recolor();
-			}
-			if (root->parent != nullptr) {
-				if (root->parent->left == root) root->parent->set_left(leftmostFromRight);
-				else root->parent->set_right(leftmostFromRight);
-			} else {
-				this->root = leftmostFromRight;
-				if (this->root != nullptr) this->root->parent = nullptr;
-			}
-			delete root;
-		} else if (root->element > element) {
-			if (root->left == nullptr) {
-			} else {
-				this->remove(root->left, element);
-			}
+		}
+		this->root = nullptr;
+	}
+
+	// Links a fresh node in as the given child of parent (or as the root when
+	// parent is nullptr) and rebalances.
+	void link(N *node, N *parent, bool asLeft) {
+		this->attach(node, parent, asLeft);
+		this->balance(node);
+	}
+
+	// Links a fresh node in red without rebalancing.
+	void attach(N *node, N *parent, bool asLeft) {
+		node->left = nullptr;
+		node->right = nullptr;
+		node->parentColor = 1;
+		if (parent == nullptr) this->root = node;
+		else if (asLeft) parent->set_left(node);
+		else parent->set_right(node);
+		this->propagate(node);
+	}
+
+	// Unlinks node from the tree without freeing it. The in-order successor
+	// is moved into its place rather than copied, so pointers to every other
+	// node stay valid.
+	void erase(N *node) {
+		N* child;
+		N* parent;
+		bool removedRed;
+		if (node->left == nullptr || node->right == nullptr) {
+			child = node->left != nullptr ? node->left : node->right;
+			parent = node->parent();
+			removedRed = node->isRed();
+			this->replace(node, child);
 		} else {
-			if (root->right == nullptr) {
+			N* successor = node->right;
+			while (successor->left != nullptr) successor = successor->left;
+			child = successor->right;
+			removedRed = successor->isRed();
+			if (successor->parent() == node) {
+				parent = successor;
 			} else {
-				this->remove(root->right, element);
+				parent = successor->parent();
+				parent->set_left(child);
+				successor->set_right(node->right);
 			}
+			this->replace(node, successor);
+			successor->set_left(node->left);
+			successor->set_red(node->isRed());
 		}
+		this->propagate(parent);
+		if (!removedRed) this->reheight(child, parent);
 	}
 
+	// Refreshes augmented data from node up to the root.
+	void propagate(N *node) {
+		if (!N::augmented) return;
+		for (; node != nullptr; node = node->parent()) node->augment();
+	}
 
-private:
-
+	static bool is_red(N *node) {
+		return node != nullptr && node->isRed();
+	}
 
-	void balance(RedBlackNode<T> *root) {
-		if (root->isRed == false) return;
-		if (root->parent == nullptr) return;
-		if (root == root->parent->left) {
-			if (root->parent->right == nullptr || !root->parent->right->isRed) this->rotate_r(root);
-			else {
-				root->recolor();
-				root->parent->right->recolor();
-				root->parent->recolor();
-				if (root->parent->parent == nullptr) {
-					root->parent->recolor();
-					return;
-				}
-				balance(root->parent->parent);
-			}
-		}//left rotate
-		else {
-			if (root->parent->left == nullptr || !root->parent->left->isRed) this->rotate_l(root);
-			else {
-				root->recolor();
-				root->parent->left->recolor();
-				root->parent->recolor();
-				if (root->parent->parent == nullptr) {
-					root->parent->recolor();
-					return;
-				}
-				balance(root->parent->parent);
-			}
+	void rotate_l(N *node) {
+		N* child = node->right;
+		node->set_right(child->left);
+		this->replace(node, child);
+		child->set_left(node);
+		if (N::augmented) {
+			node->augment();
+			child->augment();
 		}
 	}
 
-	void rotate_l(RedBlackNode<T> *root) {
-		RedBlackNode<T> *parent = root->parent;
-		if (root->left != nullptr && root->left->isRed) {
-			RedBlackNode<T> *badChild = root->left;
-			root->set_left(badChild->right);
-			badChild->set_right(root);
-			parent->set_right(badChild);
-			root = badChild;
-		}
-		root->recolor();
-		parent->recolor();
-		parent->set_right(root->left);
-		if (parent->parent != nullptr) {
-			if (parent->parent->left == parent) parent->parent->set_left(root);
-			else parent->parent->set_right(root);
-		} else {
-			this->root = root;
-			this->root->parent = nullptr;
-			root = this->root;
+	void rotate_r(N *node) {
+		N* child = node->left;
+		node->set_left(child->right);
+		this->replace(node, child);
+		child->set_right(node);
+		if (N::augmented) {
+			node->augment();
+			child->augment();
 		}
-		root->set_left(parent);
 	}
 
-	void rotate_r(RedBlackNode<T> *root) {
-		RedBlackNode<T> *parent = root->parent;
-		if (root->right != nullptr && root->right->isRed) {
-			RedBlackNode<T> *badChild = root->right;
-			root->set_right(badChild->left);
-			badChild->set_left(root);
-			parent->set_left(badChild);
-			root = badChild;
-		}
-		root->recolor();
-		parent->recolor();
-		parent->set_left(root->right);
-		if (parent->parent != nullptr) {
-			if (parent->parent->left == parent) parent->parent->set_left(root);
-			else parent->parent->set_right(root);
+private:
+
+	// Puts with in the place node occupies under its parent.
+	void replace(N *node, N *with) {
+		N* parent = node->parent();
+		if (parent == nullptr) {
+			this->root = with;
+			if (with != nullptr) with->set_parent(nullptr);
+		} else if (parent->left == node) {
+			parent->set_left(with);
 		} else {
-			this->root = root;
-			this->root->parent = nullptr;
-			root = this->root;
+			parent->set_right(with);
 		}
-		root->set_right(parent);
-	}
-
-	void reheight(RedBlackNode<T> *root) {
-		RedBlackNode<T>* parent = root->parent;
-		if (parent == nullptr) return;
-		if (root == parent->left) {
-			if (parent->isRed) {
-				if ((parent->right->left != nullptr && parent->right->left->isRed)
-						|| (parent->right->right != nullptr && parent->right->right->isRed)) {
-					rotate_l1(parent->right);
-				} else {
-					parent->right->recolor();
+	}
+
+	// Restores the red-black properties after node was linked in red.
+	void balance(N *node) {
+		while (is_red(node->parent())) {
+			N* parent = node->parent();
+			N* grandParent = parent->parent();
+			if (parent == grandParent->left) {
+				N* uncle = grandParent->right;
+				if (is_red(uncle)) {
 					parent->recolor();
+					uncle->recolor();
+					grandParent->recolor();
+					node = grandParent;
+					continue;
+				}
+				if (node == parent->right) {
+					this->rotate_l(parent);
+					parent = node;
 				}
+				parent->recolor();
+				grandParent->recolor();
+				this->rotate_r(grandParent);
 			} else {
-				if (parent->right->isRed) {
-					if ((parent->right->left->right != nullptr && parent->right->left->right->isRed)
-							|| (parent->right->left->left != nullptr && parent->right->left->left->isRed)) {
-						rotate_l2(parent->right);
-					} else {
-						rotate_l3(parent->right);
-					}
-				} else {
-					if ((parent->right->left != nullptr && parent->right->left->isRed)
-							|| (parent->right->right != nullptr && parent->right->right->isRed)) {
-						rotate_l4(parent->right);
-					} else {
-						parent->right->recolor();
-						if (parent->parent != nullptr) reheight(parent);
-					}
+				N* uncle = grandParent->left;
+				if (is_red(uncle)) {
+					parent->recolor();
+					uncle->recolor();
+					grandParent->recolor();
+					node = grandParent;
+					continue;
+				}
+				if (node == parent->left) {
+					this->rotate_r(parent);
+					parent = node;
 				}
+				parent->recolor();
+				grandParent->recolor();
+				this->rotate_l(grandParent);
 			}
-		} else {
-			if (parent->isRed) {
-				if ((parent->left->left != nullptr && parent->left->left->isRed)
-						|| (parent->left->right != nullptr && parent->left->right->isRed)) {
-					rotate_r1(parent->left);
-				} else {
-					parent->left->recolor();
+			break;
+		}
+		this->root->set_red(false);
+	}
+
+	// Restores the red-black properties after a black node was unlinked.
+	// node (possibly nullptr) carries the missing black and sits under parent.
+	void reheight(N *node, N *parent) {
+		while (node != this->root && !is_red(node)) {
+			if (node == parent->left) {
+				N* sibling = parent->right;
+				if (sibling->isRed()) {
+					sibling->recolor();
 					parent->recolor();
+					this->rotate_l(parent);
+					sibling = parent->right;
+				}
+				if (!is_red(sibling->left) && !is_red(sibling->right)) {
+					sibling->recolor();
+					node = parent;
+					parent = node->parent();
+					continue;
+				}
+				if (!is_red(sibling->right)) {
+					sibling->left->recolor();
+					sibling->recolor();
+					this->rotate_r(sibling);
+					sibling = parent->right;
 				}
+				sibling->set_red(parent->isRed());
+				parent->set_red(false);
+				sibling->right->set_red(false);
+				this->rotate_l(parent);
 			} else {
-				if (parent->left->isRed) {
-					if ((parent->left->right->right != nullptr && parent->left->right->right->isRed)
-							|| (parent->left->right->left != nullptr && parent->left->right->left->isRed)) {
-						rotate_r2(parent->left);
+				N* sibling = parent->left;
+				if (sibling->isRed()) {
+					sibling->recolor();
+					parent->recolor();
+					this->rotate_r(parent);
+					sibling = parent->left;
+				}
+				if (!is_red(sibling->left) && !is_red(sibling->right)) {
+					sibling->recolor();
+					node = parent;
+					parent = node->parent();
+					continue;
+				}
+				if (!is_red(sibling->left)) {
+					sibling->right->recolor();
+					sibling->recolor();
+					this->rotate_l(sibling);
+					sibling = parent->left;
+				}
+				sibling->set_red(parent->isRed());
+				parent->set_red(false);
+				sibling->left->set_red(false);
+				this->rotate_r(parent);
+			}
+			node = this->root;
+		}
+		if (node != nullptr) node->set_red(false);
+	}
+
+};
+
+template <class T>
+class RedBlackTree : public AbstractTree<T>, protected RedBlackBase<RedBlackNode<T>> {
+public:
+	// Handle to a stored element, valid until that element is removed.
+	typedef const RedBlackNode<T>* Position;
+
+	RedBlackTree() : leftmost(nullptr), rightmost(nullptr) {
+	}
+
+	RedBlackTree(const RedBlackTree &) = delete;
+	RedBlackTree & operator=(const RedBlackTree &) = delete;
+
+	~RedBlackTree() {
+		clear();
+	}
+
+	bool empty() const override {
+		return this->root == nullptr;
+	}
+
+	void clear() override {
+		this->drain([](RedBlackNode<T> *node) { delete node; });
+		leftmost = nullptr;
+		rightmost = nullptr;
+	}
+
+	Optional<T> find(const T & element) override {
+		RedBlackNode<T>* node = this->find(this->root, element);
+		if (node == nullptr) return Optional<T>();
+
+		return Optional<T>(node->element);
+	}
+
+	void insert(const T & element) override {
+		this->insert(nullptr, element);
+	}
+
+	// Inserts element using hint, typically the position returned by the
+	// previous insert. When element belongs right next to hint the search
+	// from the root is skipped, so nearly sorted input costs amortized O(1)
+	// per element plus rebalancing. Returns the position of element.
+	Position insert(Position hint, const T & element) {
+		RedBlackNode<T>* node = const_cast<RedBlackNode<T>*>(hint);
+		RedBlackNode<T>* parent = nullptr;
+		bool asLeft = false;
+		if (node != nullptr) {
+			if (node->element < element) {
+				RedBlackNode<T>* next = node == rightmost ? nullptr : this->next(node);
+				if (next == nullptr || element < next->element) {
+					if (node->right == nullptr) {
+						parent = node;
 					} else {
-						rotate_r3(parent->left);
+						parent = next;
+						asLeft = true;
 					}
-				} else {
-					if ((parent->left->left != nullptr && parent->left->left->isRed)
-							|| (parent->left->right != nullptr && parent->left->right->isRed)) {
-						rotate_r4(parent->left);
+				}
+			} else if (element < node->element) {
+				RedBlackNode<T>* prev = node == leftmost ? nullptr : this->prev(node);
+				if (prev == nullptr || prev->element < element) {
+					if (node->left == nullptr) {
+						parent = node;
+						asLeft = true;
 					} else {
-						parent->left->recolor();
-						if (parent->parent != nullptr) reheight(parent);
+						parent = prev;
 					}
 				}
+			} else {
+				return node;
 			}
 		}
-	}
-
-	void rotate_l1(RedBlackNode<T> *root) {
-		RedBlackNode<T> *parent = root->parent;
-		if (root->left != nullptr && root->left->isRed) {
-			RedBlackNode<T> *badChild = root->left;
-			root->set_left(badChild->right);
-			badChild->set_right(root);
-			parent->set_right(badChild);
-			root = badChild;
-			parent->recolor();
-		} else {
-			root->right->recolor();
-			root->recolor();
-			parent->recolor();
-		}
-		parent->set_right(root->left);
-		if (parent->parent != nullptr) {
-			if (parent->parent->left == parent) parent->parent->set_left(root);
-			else parent->parent->set_right(root);
-		} else {
-			this->root = root;
-			this->root->parent = nullptr;
-			root = this->root;
-		}
-		root->set_left(parent);
-	}
-
-	void rotate_l2(RedBlackNode<T> *root) {
-		RedBlackNode<T>* parent = root->parent;
-		RedBlackNode<T>* grandParent = parent->parent;
-		if (root->left->left != nullptr && root->left->left->isRed) {
-			RedBlackNode<T> *badChild = root->left->left;
-			root->left->set_left(badChild->right);
-			badChild->set_right(root->left);
-			root->set_left(badChild);
-			badChild->right->recolor();
-			badChild->recolor();
-		}
-		parent->set_right(root->left->left);
-		root->left->set_left(parent);
-		root->set_left(root->left->right);
-		root->left->recolor();
-		parent->parent->set_right(root);
-		if (grandParent != nullptr) {
-			if (grandParent->left == parent) grandParent->set_left(parent->parent);
-			else grandParent->set_right(parent->parent);
-		} else {
-			this->root = parent->parent;
-			this->root->parent = nullptr;
+		if (parent == nullptr) {
+			node = this->root;
+			while (node != nullptr) {
+				parent = node;
+				if (element < node->element) node = node->left;
+				else if (node->element < element) node = node->right;
+				else return node;
+			}
+			asLeft = parent != nullptr && element < parent->element;
 		}
+
+		node = new RedBlackNode<T>(element);
+		this->link(node, parent, asLeft);
+		if (leftmost == nullptr || element < leftmost->element) leftmost = node;
+		if (rightmost == nullptr || rightmost->element < element) rightmost = node;
+		return node;
 	}
 
-	void rotate_l3(RedBlackNode<T> *root) {
-		RedBlackNode<T>* parent = root->parent;
-		root->left->recolor();
-		parent->set_right(root->left);
-		root->recolor();
-		if (parent->parent != nullptr) {
-			if (parent->parent->left == parent) parent->parent->set_left(root);
-			else parent->parent->set_right(root);
-		} else {
-			this->root = root;
-			this->root->parent = nullptr;
-		}
-		root->set_left(parent);
-	}
-
-	void rotate_l4(RedBlackNode<T> *root) {
-		RedBlackNode<T> *parent = root->parent;
-		if (root->left != nullptr && root->left->isRed) {
-			RedBlackNode<T> *badChild = root->left;
-			root->set_left(badChild->right);
-			badChild->set_right(root);
-			parent->set_right(badChild);
-			root = badChild;
-			root->recolor();
-		} else {
-			root->right->recolor();
-		}
-		parent->set_right(root->left);
-		if (parent->parent != nullptr) {
-			if (parent->parent->left == parent) parent->parent->set_left(root);
-			else parent->parent->set_right(root);
-		} else {
-			this->root = root;
-			this->root->parent = nullptr;
-			root = this->root;
-		}
-		root->set_left(parent);
-	}
-
-	void rotate_r1(RedBlackNode<T> *root) {
-		RedBlackNode<T> *parent = root->parent;
-		if (root->right != nullptr && root->right->isRed) {
-			RedBlackNode<T> *badChild = root->right;
-			root->set_right(badChild->left);
-			badChild->set_left(root);
-			parent->set_left(badChild);
-			root = badChild;
-			parent->recolor();
-		} else {
-			root->left->recolor();
-			root->recolor();
-			parent->recolor();
-		}
-		parent->set_left(root->right);
-		if (parent->parent != nullptr) {
-			if (parent->parent->left == parent) parent->parent->set_left(root);
-			else parent->parent->set_right(root);
-		} else {
-			this->root = root;
-			this->root->parent = nullptr;
-			root = this->root;
-		}
-		root->set_right(parent);
-	}
-
-	void rotate_r2(RedBlackNode<T> *root) {
-		RedBlackNode<T>* parent = root->parent;
-		RedBlackNode<T>* grandParent = parent->parent;
-		if (root->right->right != nullptr && root->right->right->isRed) {
-			RedBlackNode<T> *badChild = root->right->right;
-			root->right->set_right(badChild->left);
-			badChild->set_left(root->right);
-			root->set_right(badChild);
-			badChild->left->recolor();
-			badChild->recolor();
-		}
-		parent->set_left(root->right->right);
-		root->right->set_right(parent);
-		root->set_right(root->right->left);
-		root->right->recolor();
-		parent->parent->set_left(root);
-		if (grandParent != nullptr) {
-			if (grandParent->left == parent) grandParent->set_left(parent->parent);
-			else grandParent->set_right(parent->parent);
-		} else {
-			this->root = parent->parent;
-			this->root->parent = nullptr;
-		}
+	void remove(const T & element) override {
+		RedBlackNode<T>* node = this->find(this->root, element);
+		if (node == nullptr) return;
+
+		if (node == leftmost) leftmost = this->next(node);
+		if (node == rightmost) rightmost = this->prev(node);
+		this->erase(node);
+		delete node;
 	}
 
-	void rotate_r3(RedBlackNode<T> *root) {
-		RedBlackNode<T>* parent = root->parent;
-		root->right->recolor();
-		parent->set_left(root->right);
-		root->recolor();
-		if (parent->parent != nullptr) {
-			if (parent->parent->left == parent) parent->parent->set_left(root);
-			else parent->parent->set_right(root);
-		} else {
-			this->root = root;
-			this->root->parent = nullptr;
-		}
-		root->set_right(parent);
-	}
-
-	void rotate_r4(RedBlackNode<T> *root) {
-		RedBlackNode<T> *parent = root->parent;
-		if (root->right != nullptr && root->right->isRed) {
-			RedBlackNode<T> *badChild = root->right;
-			root->set_right(badChild->left);
-			badChild->set_left(root);
-			parent->set_left(badChild);
-			root = badChild;
-			root->recolor();
-		} else {
-			root->left->recolor();
-		}
-		parent->set_left(root->right);
-		if (parent->parent != nullptr) {
-			if (parent->parent->left == parent) parent->parent->set_left(root);
-			else parent->parent->set_right(root);
-		} else {
-			this->root = root;
-			this->root->parent = nullptr;
-			root = this->root;
+protected:
+
+	// Smallest and largest nodes, so hints at either end need no climb.
+	RedBlackNode<T>* leftmost;
+	RedBlackNode<T>* rightmost;
+
+	RedBlackNode<T>* find(RedBlackNode<T> *root, const T & element) const {
+		while (root != nullptr) {
+			if (element < root->element) root = root->left;
+			else if (root->element < element) root = root->right;
+			else return root;
 		}
-		root->set_right(parent);
+		return nullptr;
 	}
 
+private:
+
 };
@@ -1,163 +1,440 @@
 #pragma once
 
-#include <stdlib.h>
-
+#include <new>
 #include <ostream>
-#include <iostream>
+#include <type_traits>
 
-template <typename T, int ML>
+#include "node_pool.hpp"
+#include "skiplist_level.hpp"
+#include "tree.hpp"
+
+template <typename T, int ML, class Level>
 class SkipList;
 
+// A node carries exactly as many forward links as its level. The links are
+// laid out inline after the element: forwards is declared with one entry and
+// the node is allocated with room for level of them.
 template <typename T, int ML>
 class SkipListNode {
-	friend class SkipList<T, ML>;
+	template <typename, int, class> friend class SkipList;
 public:
 
 protected:
 
 	T element;
-	SkipListNode<T, ML>* forwards[ML + 1];
+	// Both share one word, so the mark costs no space. deleted means
+	// removed but not yet unlinked; see SkipList::purge().
+	unsigned level : 31;
+	unsigned deleted : 1;
+	SkipListNode<T, ML>* forwards[1];
 
-	SkipListNode() {std::cout << "boom" << std::endl;
-		for (int i = 1; i <= ML; i++) {
-			forwards[i] = nullptr;
+	SkipListNode(const T & element, int level) : element(element), level(level), deleted(false) {
+		for (int i = 1; i <= level; i++) {
+			this->next(i) = nullptr;
 		}
 	}
 
-	SkipListNode(T element) : element(element) {
-		for (int i = 1; i <= ML; i++) {
-			forwards[i] = nullptr;
-		}
+	// Bytes taken by a node with level forward links.
+	static size_t bytes(int level) {
+		return sizeof(SkipListNode) + (level - 1) * sizeof(SkipListNode*);
+	}
+
+	// Forward link at level, counting from 1.
+	SkipListNode*& next(int level) {
+		return forwards[level - 1];
 	}
 
 private:
 
 };
 
-template <typename T, int ML = 16>
+// The header carries no element and the last node links to nullptr, so
+// searches compare only against real elements and T needs no sentinel
+// values. Level draws the level of a new node as generator(ML); see
+// GeometricLevel.
+//
+// With a purge threshold set, remove() only marks the node deleted, which
+// costs one search, and the marked nodes are unlinked together by purge():
+// one pass along level 1 that splices them out of every level. purge() runs
+// by itself once threshold nodes are marked; it visits every node, so the
+// threshold should grow with the list.
+template <typename T, int ML = 16, class Level = GeometricLevel>
 class SkipList : public AbstractTree<T> {
 public:
 	typedef SkipListNode<T, ML> NodeType;
 
-	SkipList(T min, T max) : min(min), max(max), max_curr_level(1) {
-		header = new NodeType(min);
-		tail = new NodeType(max);
-		for (int i = 1; i <= ML; i++) {
-			header->forwards[i] = tail;
-		}
+	SkipList(Level generator = Level()) : generator(generator), max_curr_level(1), version(0), finger(*this), purge_threshold(0), tombstones(0) {
+		header = newHeader();
+	}
+
+	// The bounds are no longer needed; kept for existing callers.
+	SkipList(const T &, const T &, Level generator = Level()) : SkipList(generator) {
 	}
 
+	SkipList(const SkipList &) = delete;
+	SkipList & operator=(const SkipList &) = delete;
+
+	// Nodes live in the arena, which frees them in bulk; they are only
+	// visited when T needs its destructor run. The header has no element.
 	virtual ~SkipList() {
-		NodeType* currNode = header->forwards[1];
-		while (currNode != tail) {
-			NodeType* tempNode = currNode;
-			currNode = currNode->forwards[1];
-			delete tempNode;
+		if (!std::is_trivially_destructible<T>::value) {
+			NodeType* currNode = header->next(1);
+			while (currNode != nullptr) {
+				NodeType* tempNode = currNode;
+				currNode = currNode->next(1);
+				tempNode->~NodeType();
+			}
 		}
-		delete header;
-		delete tail;
 	}
 
-	void insert(const T & element) override {
-		SkipListNode<T, ML>* update[ML];
-		NodeType* currNode = header;
-		for (int level = max_curr_level; level >= 1; level--) {
-			while (currNode->forwards[level]->element < element) {
-				currNode = currNode->forwards[level];
+	// Remembers where the last operation through it ended (the last node
+	// before that element on every level) and starts the next one from
+	// there, climbing only as high as it has to. An operation d elements
+	// away from the previous one costs O(log d) expected instead of
+	// O(log n). Changing the list other than through this cursor sends its
+	// next search back to the header, and current() returns nothing until
+	// then.
+	class Cursor {
+		friend class SkipList;
+	public:
+
+		explicit Cursor(SkipList & list) : list(list), seen(list.version - 1) {
+		}
+
+		Optional<T> find(const T & element) {
+			NodeType* node = list.seek(element, update, seen);
+			if (node != nullptr && !node->deleted && node->element == element) {
+				return Optional<T>(node->element);
 			}
-			update[level] = currNode;
+			return Optional<T>();
 		}
-		currNode = currNode->forwards[1];
-		if (currNode->element == element) {
-			//skip
-		} else {
-			int newlevel = randomLevel();
-			if (newlevel > max_curr_level) {
-				for (int level = max_curr_level + 1; level <= newlevel; level++) {
-					update[level] = header;
-				}
-				max_curr_level = newlevel;
+
+		void insert(const T & element) {
+			list.insert(element, update, seen);
+		}
+
+		void remove(const T & element) {
+			list.remove(element, update, seen);
+		}
+
+		// Positions the cursor at the first element not less than element.
+		void seek(const T & element) {
+			list.seek(element, update, seen);
+		}
+
+		// Element the cursor is at, or nothing at the end.
+		Optional<T> current() const {
+			NodeType* node = seen == list.version ? list.live(update[1]->next(1)) : nullptr;
+			if (node == nullptr) {
+				return Optional<T>();
 			}
-			currNode = new NodeType(element);
-			for (int lv = 1; lv <= max_curr_level; lv++) {
-				currNode->forwards[lv] = update[lv]->forwards[lv];
-				update[lv]->forwards[lv] = currNode;
+			return Optional<T>(node->element);
+		}
+
+		// Steps to the next element. Marked nodes on the way are passed on
+		// all their levels too, or update[] would no longer be one search
+		// path and a later insert could link behind them.
+		void next() {
+			if (seen != list.version) return;
+			NodeType* node = update[1]->next(1);
+			while (node != nullptr) {
+				for (int lv = 1; lv <= node->level; lv++) {
+					update[lv] = node;
+				}
+				if (!node->deleted) return;
+				node = node->next(1);
 			}
 		}
+
+	protected:
+
+		SkipList & list;
+		NodeType* update[ML + 1];
+		// list.version that update[] is valid for.
+		unsigned long seen;
+
+	private:
+
+	};
+
+	void insert(const T & element) override {
+		this->insert(element, finger.update, finger.seen);
 	}
 
 	void remove(const T & element) override {
-		SkipListNode<T, ML>* update[ML];
-		NodeType* currNode = header;
-		for (int level = max_curr_level; level >= 1; level--) {
-			while (currNode->forwards[level]->element < element) {
-				currNode = currNode->forwards[level];
+		this->remove(element, finger.update, finger.seen);
+	}
+
+	Optional<T> find(const T & element) override {
+		return finger.find(element);
+	}
+
+	bool empty() const override {
+		return this->live(header->next(1)) == nullptr;
+	}
+
+	// 0, the default, makes remove() unlink at once; otherwise it defers
+	// until threshold nodes are marked. Purges if that many already are.
+	void set_purge_threshold(size_t threshold) {
+		purge_threshold = threshold;
+		if (tombstones > 0 && tombstones >= purge_threshold) this->purge();
+	}
+
+	// Unlinks and frees every node marked by remove(), in one pass along
+	// level 1 that keeps the last surviving node of each level.
+	void purge() {
+		if (tombstones == 0) return;
+
+		NodeType* last[ML + 1];
+		for (int lv = 1; lv <= max_curr_level; lv++) {
+			last[lv] = header;
+		}
+		NodeType* currNode = header->next(1);
+		while (currNode != nullptr) {
+			NodeType* next = currNode->next(1);
+			if (currNode->deleted) {
+				for (int lv = 1; lv <= currNode->level; lv++) {
+					last[lv]->next(lv) = currNode->next(lv);
+				}
+				deleteNode(currNode);
+			} else {
+				for (int lv = 1; lv <= currNode->level; lv++) {
+					last[lv] = currNode;
+				}
 			}
-			update[level] = currNode;
+			currNode = next;
+		}
+		tombstones = 0;
+		while (max_curr_level > 1 && header->next(max_curr_level) == nullptr) {
+			max_curr_level--;
 		}
-		currNode = currNode->forwards[1];
-		if (currNode->element == element) {
-			for (int lv = 1; lv <= max_curr_level; lv++) {
-				if (update[lv]->forwards[lv] != currNode) {
-					break;
+		version++;
+	}
+
+	// Moves every element of other into this list in one pass over both,
+	// relinking other's nodes at the levels they already have; nothing is
+	// copied or allocated. Where both lists hold an element, this list's
+	// copy stays. other is left empty.
+	void merge(SkipList && other) {
+		if (&other == this) return;
+
+		this->purge();
+		other.purge();
+
+		arena.adopt(other.arena);
+		// last[lv] is the newest node linked on level lv.
+		NodeType* last[ML + 1];
+		for (int lv = 1; lv <= ML; lv++) {
+			last[lv] = header;
+		}
+		NodeType* mine = header->next(1);
+		NodeType* theirs = other.header->next(1);
+		while (mine != nullptr || theirs != nullptr) {
+			NodeType* node;
+			if (theirs == nullptr || (mine != nullptr && !(theirs->element < mine->element))) {
+				node = mine;
+				mine = mine->next(1);
+				if (theirs != nullptr && theirs->element == node->element) {
+					NodeType* tempNode = theirs;
+					theirs = theirs->next(1);
+					deleteNode(tempNode);
 				}
-				update[lv]->forwards[lv] = currNode->forwards[lv];
+			} else {
+				node = theirs;
+				theirs = theirs->next(1);
 			}
-			delete currNode;
-			// update the max level
-			while (max_curr_level > 1 && header->forwards[max_curr_level] == nullptr) {
-				max_curr_level--;
+			for (int lv = 1; lv <= node->level; lv++) {
+				last[lv]->next(lv) = node;
+				last[lv] = node;
 			}
 		}
+		for (int lv = 1; lv <= ML; lv++) {
+			last[lv]->next(lv) = nullptr;
+		}
+		max_curr_level = ML;
+		while (max_curr_level > 1 && header->next(max_curr_level) == nullptr) {
+			max_curr_level--;
+		}
+		version++;
+
+		// other's header came along with its arena.
+		arena.deallocate(other.header, NodeType::bytes(ML));
+		other.header = other.newHeader();
+		other.max_curr_level = 1;
+		other.version++;
 	}
 
-	Optional<T> find(const T & element) override {
+	// Removes every element x with lo <= x <= hi. One walk along the
+	// segment frees it and notes where each level resumes past it, so this
+	// costs O(log n + k) expected for k elements removed.
+	void erase_range(const T & lo, const T & hi) {
+		NodeType** update = finger.update;
+		NodeType* currNode = this->seek(lo, update, finger.seen);
+		if (currNode == nullptr || hi < currNode->element) return;
+
+		// after[lv] is the first node past the segment on level lv.
+		NodeType* after[ML + 1];
+		for (int lv = 2; lv <= max_curr_level; lv++) {
+			after[lv] = update[lv]->next(lv);
+		}
+		while (currNode != nullptr && !(hi < currNode->element)) {
+			for (int lv = 2; lv <= currNode->level; lv++) {
+				after[lv] = currNode->next(lv);
+			}
+			NodeType* tempNode = currNode;
+			currNode = currNode->next(1);
+			if (tempNode->deleted) tombstones--;
+			deleteNode(tempNode);
+		}
+		update[1]->next(1) = currNode;
+		for (int lv = 2; lv <= max_curr_level; lv++) {
+			update[lv]->next(lv) = after[lv];
+		}
+		while (max_curr_level > 1 && header->next(max_curr_level) == nullptr) {
+			max_curr_level--;
+		}
+		// update[] still brackets lo.
+		finger.seen = ++version;
+	}
+
+	void print(std::ostream & stream) const override {
+		NodeType* currNode = this->live(header->next(1));
+		while (currNode != nullptr) {
+			stream << "(" << currNode->element << ")" << std::endl;
+			currNode = this->live(currNode->next(1));
+		}
+	}
+
+protected:
+
+	// Fills update[lv] with the last node before element on every level and
+	// returns the node after update[1]. update[] is reused from the previous
+	// search when seen says the list has not changed since: the search then
+	// climbs to the lowest level whose entry is still right for element and
+	// only descends from there.
+	NodeType* seek(const T & element, NodeType** update, unsigned long & seen) {
 		NodeType* currNode = header;
-		for (int level = max_curr_level; level >= 1; level--) {
-			while (currNode->forwards[level]->element < element) {
-				currNode = currNode->forwards[level];
+		int top = max_curr_level;
+		if (seen == version) {
+			int level = 1;
+			while (level < max_curr_level && !this->brackets(update[level], level, element)) {
+				level++;
+			}
+			if (update[level] == header || update[level]->element < element) {
+				currNode = update[level];
+				top = level;
 			}
 		}
-		currNode = currNode->forwards[1];
-		if (currNode->element == element) {
-			return Optional<T>(currNode->element);
-		} else {
-			return Optional<T>();
+		for (int level = top; level >= 1; level--) {
+			while (this->precedes(currNode->next(level), element)) {
+				currNode = currNode->next(level);
+			}
+			update[level] = currNode;
 		}
+		seen = version;
+		return currNode->next(1);
 	}
 
-	bool empty() const override {
-		return ( header->forwards[1] == tail);
+	// True when node is the last one before element on level.
+	bool brackets(NodeType *node, int level, const T & element) const {
+		return (node == header || node->element < element) && !this->precedes(node->next(level), element);
 	}
 
-	void print(std::ostream stream) {
-		NodeType* currNode = header->forwards[1];
-		while (currNode != tail) {
-			stream << "(" << currNode->element << ")" << std::endl;
-			currNode = currNode->forwards[1];
+	// First unmarked node from node on, or nullptr.
+	NodeType* live(NodeType *node) const {
+		while (node != nullptr && node->deleted) {
+			node = node->next(1);
 		}
+		return node;
 	}
 
-protected:
+	// True when node is a real node before element; the end is never before.
+	static bool precedes(NodeType *node, const T & element) {
+		return node != nullptr && node->element < element;
+	}
+
+	void insert(const T & element, NodeType** update, unsigned long & seen) {
+		NodeType* currNode = this->seek(element, update, seen);
+		if (currNode != nullptr && currNode->element == element) {
+			if (currNode->deleted) {
+				currNode->element = element;
+				currNode->deleted = false;
+				tombstones--;
+			}
+		} else {
+			int newlevel = randomLevel();
+			if (newlevel > max_curr_level) {
+				for (int level = max_curr_level + 1; level <= newlevel; level++) {
+					update[level] = header;
+				}
+				max_curr_level = newlevel;
+			}
+			currNode = newNode(element, newlevel);
+			for (int lv = 1; lv <= newlevel; lv++) {
+				currNode->next(lv) = update[lv]->next(lv);
+				update[lv]->next(lv) = currNode;
+			}
+			// update[] still brackets element.
+			seen = ++version;
+		}
+	}
 
-	double uniformRandom() {
-		return rand() / double(RAND_MAX);
+	void remove(const T & element, NodeType** update, unsigned long & seen) {
+		NodeType* currNode = this->seek(element, update, seen);
+		if (currNode != nullptr && !currNode->deleted && currNode->element == element) {
+			if (purge_threshold > 0) {
+				currNode->deleted = true;
+				if (++tombstones >= purge_threshold) this->purge();
+				return;
+			}
+			for (int lv = 1; lv <= currNode->level; lv++) {
+				update[lv]->next(lv) = currNode->next(lv);
+			}
+			deleteNode(currNode);
+			// update the max level
+			while (max_curr_level > 1 && header->next(max_curr_level) == nullptr) {
+				max_curr_level--;
+			}
+			seen = ++version;
+		}
 	}
 
 	int randomLevel() {
-		int level = 1;
-		double p = 0.5;
-		while (uniformRandom() < p && level < ML) {
-			level++;
+		return this->generator(ML);
+	}
+
+	// Storage for a node of level ML with only its links set; it never
+	// holds an element, so it is never destroyed as a node.
+	NodeType* newHeader() {
+		NodeType* node = static_cast<NodeType*>(arena.allocate(NodeType::bytes(ML)));
+		node->level = ML;
+		for (int i = 1; i <= ML; i++) {
+			node->next(i) = nullptr;
 		}
-		return level;
+		return node;
+	}
+
+	NodeType* newNode(const T & element, int level) {
+		return new (arena.allocate(NodeType::bytes(level))) NodeType(element, level);
+	}
+
+	void deleteNode(NodeType *node) {
+		int level = node->level;
+		node->~NodeType();
+		arena.deallocate(node, NodeType::bytes(level));
 	}
 
-	T min;
-	T max;
+	NodeArena<alignof(NodeType)> arena;
+	Level generator;
 	int max_curr_level;
 	SkipListNode<T, ML>* header;
-	SkipListNode<T, ML>* tail;
+	// Bumped whenever links change.
+	unsigned long version;
+	// Where find(), insert() and remove() start from.
+	Cursor finger;
+	size_t purge_threshold;
+	// Nodes marked deleted.
+	size_t tombstones;
 
 private:
 
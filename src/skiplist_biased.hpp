@@ -0,0 +1,248 @@
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <ostream>
+#include <type_traits>
+
+#include "node_pool.hpp"
+#include "skiplist_level.hpp"
+#include "tree.hpp"
+
+template <typename T, int ML, class Level>
+class BiasedSkipList;
+
+// As in SkipListNode, a node carries exactly level forward links, so
+// raising its level means moving it to a bigger node.
+template <typename T, int ML>
+class BiasedSkipListNode {
+	template <typename, int, class> friend class BiasedSkipList;
+public:
+
+protected:
+
+	T element;
+	int level;
+	// Lookups since the node last moved up. Counted by find(), which may run
+	// in several threads at once, so it is atomic and counted relaxed.
+	std::atomic<unsigned long> hits;
+	BiasedSkipListNode* forwards[1];
+
+	BiasedSkipListNode(const T & element, int level) : element(element), level(level), hits(0) {
+		for (int i = 1; i <= level; i++) {
+			this->next(i) = nullptr;
+		}
+	}
+
+	static size_t bytes(int level) {
+		return sizeof(BiasedSkipListNode) + (level - 1) * sizeof(BiasedSkipListNode*);
+	}
+
+	BiasedSkipListNode*& next(int level) {
+		return forwards[level - 1];
+	}
+
+private:
+
+};
+
+// Skip list that moves frequently found elements up. New nodes get a random
+// level as usual; every find() counts a hit on the node, and rebalance()
+// raises each node at level L that has collected threshold * 2^(L - 1)
+// hits by one level, up to one above the current top. Under a skewed load
+// the hot elements end up on the upper levels and are found in a few hops
+// from the header, much as a splay tree keeps them near the root, but
+// without restructuring on each lookup. Doubling the bar per level keeps
+// the upper levels sparse; nodes are never lowered again.
+//
+// find() changes no links; its only write is the relaxed hit count, so
+// several threads may call it at once while no writer runs. rebalance()
+// relinks nodes and is a write like insert() and remove(); call it every
+// so many operations or on a timer.
+//
+// The header carries no element and the list ends in nullptr.
+template <typename T, int ML = 16, class Level = GeometricLevel>
+class BiasedSkipList : public AbstractTree<T> {
+public:
+	typedef BiasedSkipListNode<T, ML> NodeType;
+
+	explicit BiasedSkipList(unsigned long threshold = 8, Level generator = Level()) : threshold(threshold < 1 ? 1 : threshold), generator(generator), max_curr_level(1) {
+		header = static_cast<NodeType*>(arena.allocate(NodeType::bytes(ML)));
+		header->level = ML;
+		for (int i = 1; i <= ML; i++) {
+			header->next(i) = nullptr;
+		}
+	}
+
+	BiasedSkipList(const BiasedSkipList &) = delete;
+	BiasedSkipList & operator=(const BiasedSkipList &) = delete;
+
+	// The header has no element to destroy.
+	virtual ~BiasedSkipList() {
+		if (!std::is_trivially_destructible<T>::value) {
+			NodeType* currNode = header->next(1);
+			while (currNode != nullptr) {
+				NodeType* tempNode = currNode;
+				currNode = currNode->next(1);
+				tempNode->~NodeType();
+			}
+		}
+	}
+
+	// Stops on the highest level where element turns up, so a node at level
+	// L is found after about max_curr_level - L levels instead of all of them.
+	Optional<T> find(const T & element) override {
+		NodeType* currNode = header;
+		// The node that ended the walk one level up; it is not less than
+		// element, so it need not be compared again (null at first).
+		NodeType* bound = nullptr;
+		for (int level = max_curr_level; level >= 1; level--) {
+			NodeType* next = currNode->next(level);
+			while (next != bound && next->element < element) {
+				currNode = next;
+				next = currNode->next(level);
+			}
+			if (next != bound && !(element < next->element)) {
+				next->hits.fetch_add(1, std::memory_order_relaxed);
+				return Optional<T>(next->element);
+			}
+			bound = next;
+		}
+		return Optional<T>();
+	}
+
+	void insert(const T & element) override {
+		NodeType* update[ML + 1];
+		NodeType* currNode = this->locate(element, update);
+		if (currNode != nullptr && !(element < currNode->element)) return;
+
+		int newlevel = this->generator(ML);
+		if (newlevel > max_curr_level) {
+			for (int level = max_curr_level + 1; level <= newlevel; level++) {
+				update[level] = header;
+			}
+			max_curr_level = newlevel;
+		}
+		currNode = newNode(element, newlevel);
+		for (int lv = 1; lv <= newlevel; lv++) {
+			currNode->next(lv) = update[lv]->next(lv);
+			update[lv]->next(lv) = currNode;
+		}
+	}
+
+	void remove(const T & element) override {
+		NodeType* update[ML + 1];
+		NodeType* currNode = this->locate(element, update);
+		if (currNode == nullptr || element < currNode->element) return;
+
+		for (int lv = 1; lv <= currNode->level; lv++) {
+			update[lv]->next(lv) = currNode->next(lv);
+		}
+		deleteNode(currNode);
+		while (max_curr_level > 1 && header->next(max_curr_level) == nullptr) {
+			max_curr_level--;
+		}
+	}
+
+	void clear() override {
+		NodeType* currNode = header->next(1);
+		while (currNode != nullptr) {
+			NodeType* tempNode = currNode;
+			currNode = currNode->next(1);
+			deleteNode(tempNode);
+		}
+		for (int i = 1; i <= ML; i++) {
+			header->next(i) = nullptr;
+		}
+		max_curr_level = 1;
+	}
+
+	bool empty() const override {
+		return header->next(1) == nullptr;
+	}
+
+	// Raises every node that has reached its bar by one level, in one pass
+	// along level 1 that keeps the last node seen on each level.
+	void rebalance() {
+		NodeType* last[ML + 1];
+		for (int lv = 1; lv <= ML; lv++) {
+			last[lv] = header;
+		}
+		NodeType* currNode = header->next(1);
+		while (currNode != nullptr) {
+			NodeType* next = currNode->next(1);
+			int level = currNode->level;
+			if (level < ML && currNode->hits.load(std::memory_order_relaxed) >= (threshold << (level - 1))) {
+				currNode = this->promote(currNode, last);
+				level++;
+			}
+			for (int lv = 1; lv <= level; lv++) {
+				last[lv] = currNode;
+			}
+			currNode = next;
+		}
+	}
+
+	void print(std::ostream & stream) const override {
+		for (NodeType* currNode = header->next(1); currNode != nullptr; currNode = currNode->next(1)) {
+			stream << "(" << currNode->element << ")" << std::endl;
+		}
+	}
+
+protected:
+
+	NodeArena<alignof(NodeType)> arena;
+	unsigned long threshold;
+	Level generator;
+	int max_curr_level;
+	NodeType* header;
+
+	// Fills update[lv] with the last node before element on every level up
+	// to the top and returns the node after update[1].
+	NodeType* locate(const T & element, NodeType** update) {
+		NodeType* currNode = header;
+		NodeType* bound = nullptr;
+		for (int level = max_curr_level; level >= 1; level--) {
+			NodeType* next = currNode->next(level);
+			while (next != bound && next->element < element) {
+				currNode = next;
+				next = currNode->next(level);
+			}
+			update[level] = currNode;
+			bound = next;
+		}
+		return currNode->next(1);
+	}
+
+	// Replaces node, found after update[], with a copy one level higher and
+	// returns the copy.
+	NodeType* promote(NodeType *node, NodeType** update) {
+		int level = node->level + 1;
+		if (level > max_curr_level) {
+			update[level] = header;
+			max_curr_level = level;
+		}
+		NodeType* raised = newNode(node->element, level);
+		for (int lv = 1; lv < level; lv++) {
+			raised->next(lv) = node->next(lv);
+			update[lv]->next(lv) = raised;
+		}
+		raised->next(level) = update[level]->next(level);
+		update[level]->next(level) = raised;
+		deleteNode(node);
+		return raised;
+	}
+
+	NodeType* newNode(const T & element, int level) {
+		return new (arena.allocate(NodeType::bytes(level))) NodeType(element, level);
+	}
+
+	void deleteNode(NodeType *node) {
+		int level = node->level;
+		node->~NodeType();
+		arena.deallocate(node, NodeType::bytes(level));
+	}
+
+private:
+
+};
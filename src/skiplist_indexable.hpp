@@ -0,0 +1,272 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <ostream>
+#include <type_traits>
+
+#include "node_pool.hpp"
+#include "skiplist_level.hpp"
+#include "tree.hpp"
+
+template <typename T, int ML, class Level>
+class IndexableSkipList;
+
+// Each forward link also counts how many level 1 steps it spans, so a
+// search can add up positions as it goes. As in SkipListNode, a node has
+// exactly level links.
+template <typename T, int ML>
+class IndexableSkipListNode {
+	template <typename, int, class> friend class IndexableSkipList;
+public:
+
+protected:
+
+	struct Link {
+		IndexableSkipListNode *next;
+		size_t width;
+	};
+
+	T element;
+	int level;
+	Link forwards[1];
+
+	IndexableSkipListNode(const T & element, int level) : element(element), level(level) {
+		for (int i = 1; i <= level; i++) {
+			this->link(i) = Link{ nullptr, 0 };
+		}
+	}
+
+	static size_t bytes(int level) {
+		return sizeof(IndexableSkipListNode) + (level - 1) * sizeof(Link);
+	}
+
+	Link& link(int level) {
+		return forwards[level - 1];
+	}
+
+private:
+
+};
+
+// Skip list with positional access. The header sits at position 0, the
+// element at index i at i + 1 and the end of the list at size() + 1; a link
+// from position p to position q has width q - p. at(), rank() and
+// erase_at() add up widths on the way down in O(log n) expected.
+//
+// The header carries no element and the list ends in nullptr, so T needs
+// no sentinel values.
+template <typename T, int ML = 16, class Level = GeometricLevel>
+class IndexableSkipList : public AbstractTree<T> {
+public:
+	typedef IndexableSkipListNode<T, ML> NodeType;
+
+	IndexableSkipList(Level generator = Level()) : generator(generator), max_curr_level(1), count(0) {
+		header = static_cast<NodeType*>(arena.allocate(NodeType::bytes(ML)));
+		header->level = ML;
+		for (int i = 1; i <= ML; i++) {
+			header->link(i) = typename NodeType::Link{ nullptr, 1 };
+		}
+	}
+
+	IndexableSkipList(const IndexableSkipList &) = delete;
+	IndexableSkipList & operator=(const IndexableSkipList &) = delete;
+
+	// The header has no element to destroy.
+	virtual ~IndexableSkipList() {
+		if (!std::is_trivially_destructible<T>::value) {
+			NodeType* currNode = header->link(1).next;
+			while (currNode != nullptr) {
+				NodeType* tempNode = currNode;
+				currNode = currNode->link(1).next;
+				tempNode->~NodeType();
+			}
+		}
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+	bool empty() const override {
+		return count == 0;
+	}
+
+	void clear() override {
+		NodeType* currNode = header->link(1).next;
+		while (currNode != nullptr) {
+			NodeType* tempNode = currNode;
+			currNode = currNode->link(1).next;
+			deleteNode(tempNode);
+		}
+		for (int i = 1; i <= ML; i++) {
+			header->link(i) = typename NodeType::Link{ nullptr, 1 };
+		}
+		max_curr_level = 1;
+		count = 0;
+	}
+
+	Optional<T> find(const T & element) override {
+		NodeType* currNode = header;
+		for (int level = max_curr_level; level >= 1; level--) {
+			while (this->precedes(currNode->link(level).next, element)) {
+				currNode = currNode->link(level).next;
+			}
+		}
+		currNode = currNode->link(1).next;
+		if (currNode != nullptr && !(element < currNode->element)) {
+			return Optional<T>(currNode->element);
+		}
+		return Optional<T>();
+	}
+
+	void insert(const T & element) override {
+		NodeType* update[ML + 1];
+		// Position of update[lv].
+		size_t position[ML + 1];
+		NodeType* currNode = header;
+		size_t travelled = 0;
+		for (int level = max_curr_level; level >= 1; level--) {
+			while (this->precedes(currNode->link(level).next, element)) {
+				travelled += currNode->link(level).width;
+				currNode = currNode->link(level).next;
+			}
+			update[level] = currNode;
+			position[level] = travelled;
+		}
+		currNode = currNode->link(1).next;
+		if (currNode != nullptr && !(element < currNode->element)) return;
+
+		int newlevel = this->generator(ML);
+		if (newlevel > max_curr_level) {
+			for (int level = max_curr_level + 1; level <= newlevel; level++) {
+				update[level] = header;
+				position[level] = 0;
+			}
+			max_curr_level = newlevel;
+		}
+		currNode = newNode(element, newlevel);
+		for (int lv = 1; lv <= newlevel; lv++) {
+			typename NodeType::Link & link = update[lv]->link(lv);
+			size_t before = travelled - position[lv];
+			currNode->link(lv) = typename NodeType::Link{ link.next, link.width - before };
+			link.next = currNode;
+			link.width = before + 1;
+		}
+		// Links passing over the new node, including the header's empty ones.
+		for (int lv = newlevel + 1; lv <= ML; lv++) {
+			(lv <= max_curr_level ? update[lv] : header)->link(lv).width++;
+		}
+		count++;
+	}
+
+	void remove(const T & element) override {
+		NodeType* update[ML + 1];
+		NodeType* currNode = header;
+		for (int level = max_curr_level; level >= 1; level--) {
+			while (this->precedes(currNode->link(level).next, element)) {
+				currNode = currNode->link(level).next;
+			}
+			update[level] = currNode;
+		}
+		currNode = currNode->link(1).next;
+		if (currNode == nullptr || element < currNode->element) return;
+
+		this->unlink(currNode, update);
+	}
+
+	// Element at position index, or nothing when index >= size().
+	Optional<T> at(size_t index) const {
+		if (index >= count) return Optional<T>();
+
+		NodeType* currNode = header;
+		size_t travelled = 0;
+		for (int level = max_curr_level; level >= 1; level--) {
+			while (currNode->link(level).next != nullptr && travelled + currNode->link(level).width <= index + 1) {
+				travelled += currNode->link(level).width;
+				currNode = currNode->link(level).next;
+			}
+			if (travelled == index + 1) break;
+		}
+		return Optional<T>(currNode->element);
+	}
+
+	// Number of elements less than element, which is its position when it
+	// is in the list.
+	size_t rank(const T & element) const {
+		NodeType* currNode = header;
+		size_t travelled = 0;
+		for (int level = max_curr_level; level >= 1; level--) {
+			while (this->precedes(currNode->link(level).next, element)) {
+				travelled += currNode->link(level).width;
+				currNode = currNode->link(level).next;
+			}
+		}
+		return travelled;
+	}
+
+	// Removes the element at position index, if there is one.
+	void erase_at(size_t index) {
+		if (index >= count) return;
+
+		NodeType* update[ML + 1];
+		NodeType* currNode = header;
+		size_t travelled = 0;
+		for (int level = max_curr_level; level >= 1; level--) {
+			while (travelled + currNode->link(level).width <= index) {
+				travelled += currNode->link(level).width;
+				currNode = currNode->link(level).next;
+			}
+			update[level] = currNode;
+		}
+		this->unlink(currNode->link(1).next, update);
+	}
+
+	void print(std::ostream & stream) const override {
+		for (NodeType* currNode = header->link(1).next; currNode != nullptr; currNode = currNode->link(1).next) {
+			stream << "(" << currNode->element << ")" << std::endl;
+		}
+	}
+
+protected:
+
+	NodeArena<alignof(NodeType)> arena;
+	Level generator;
+	int max_curr_level;
+	size_t count;
+	NodeType* header;
+
+	static bool precedes(NodeType *node, const T & element) {
+		return node != nullptr && node->element < element;
+	}
+
+	// Unlinks node, whose predecessor on each level lv is update[lv].
+	void unlink(NodeType *node, NodeType** update) {
+		for (int lv = 1; lv <= node->level; lv++) {
+			typename NodeType::Link & link = update[lv]->link(lv);
+			link.width += node->link(lv).width - 1;
+			link.next = node->link(lv).next;
+		}
+		for (int lv = node->level + 1; lv <= ML; lv++) {
+			(lv <= max_curr_level ? update[lv] : header)->link(lv).width--;
+		}
+		deleteNode(node);
+		count--;
+		while (max_curr_level > 1 && header->link(max_curr_level).next == nullptr) {
+			max_curr_level--;
+		}
+	}
+
+	NodeType* newNode(const T & element, int level) {
+		return new (arena.allocate(NodeType::bytes(level))) NodeType(element, level);
+	}
+
+	void deleteNode(NodeType *node) {
+		int level = node->level;
+		node->~NodeType();
+		arena.deallocate(node, NodeType::bytes(level));
+	}
+
+private:
+
+};
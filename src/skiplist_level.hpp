@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// Level generator for skip lists: draws level L with probability
+// p^(L - 1) * (1 - p), where p = 2^-k, capped at max. One random word gives
+// the level at once: its leading zero count is at least j with probability
+// 2^-j, so every k zeros are one more level. (Leading rather than trailing
+// zeros, since the xorshift* multiply mixes towards the high bits.)
+//
+// Unseeded generators draw from a per-thread xorshift state, so lists on
+// different threads never contend. A seeded generator keeps its own state
+// and repeats the same levels for the same seed.
+class GeometricLevel {
+public:
+
+	explicit GeometricLevel(int k = 1) : k(k < 1 ? 1 : k), seeded(false), state(0) {
+	}
+
+	GeometricLevel(int k, uint64_t seed) : k(k < 1 ? 1 : k), seeded(true), state(seed == 0 ? 1 : seed) {
+	}
+
+	int operator()(int max) {
+		uint64_t word = this->seeded ? step(this->state) : step(local());
+		int level = 1 + leading_zeros(word) / this->k;
+		return level < max ? level : max;
+	}
+
+protected:
+
+	int k;
+	bool seeded;
+	uint64_t state;
+
+	static uint64_t & local() {
+		static thread_local uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+		return state;
+	}
+
+	// xorshift64*
+	static uint64_t step(uint64_t & state) {
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 2685821657736338717ULL;
+	}
+
+	static int leading_zeros(uint64_t word) {
+		if (word == 0) return 64;
+#if defined(__GNUC__)
+		return __builtin_clzll(word);
+#else
+		int zeros = 0;
+		while ((word >> 63) == 0) {
+			word <<= 1;
+			zeros++;
+		}
+		return zeros;
+#endif
+	}
+
+private:
+
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+#include "epoch.hpp"
+#include "skiplist_level.hpp"
+#include "tree.hpp"
+
+template <typename T, int ML, class Level>
+class LockFreeSkipList;
+
+// Forward links are words holding the successor with the low bit set once
+// this node is deleted at that level. Like SkipListNode, a node is allocated
+// with room for exactly level links.
+template <typename T, int ML>
+class LockFreeSkipListNode {
+	template <typename, int, class> friend class LockFreeSkipList;
+public:
+
+protected:
+
+	typedef std::atomic<uintptr_t> Link;
+
+	const T element;
+	const int level;
+	// Dropped by the inserter once it stops linking and by the remover once
+	// the node is unlinked; the last one retires the node.
+	std::atomic<int> owners;
+	Link forwards[1];
+
+	LockFreeSkipListNode(const T & element, int level) : element(element), level(level), owners(2) {
+		for (int i = 1; i < level; i++) {
+			new (&forwards[i]) Link(0);
+		}
+		forwards[0].store(0, std::memory_order_relaxed);
+	}
+
+	static size_t bytes(int level) {
+		return sizeof(LockFreeSkipListNode) + (level - 1) * sizeof(Link);
+	}
+
+	static LockFreeSkipListNode* make(const T & element, int level) {
+		return new (::operator new(bytes(level))) LockFreeSkipListNode(element, level);
+	}
+
+	static void destroy(void *pointer) {
+		static_cast<LockFreeSkipListNode*>(pointer)->~LockFreeSkipListNode();
+		::operator delete(pointer);
+	}
+
+private:
+
+};
+
+// Lock-free skip list (Herlihy and Shavit's LockFreeSkipList, after
+// Fraser). Every operation may run on any thread at any time.
+//
+// A node is in the set once it is linked at level 1 and until its level 1
+// link is marked; the upper levels are only shortcuts. remove() marks the
+// links top down, and any search that meets a marked node unlinks it with a
+// CAS on its predecessor, so a marked predecessor makes the CAS fail and
+// the search start over. find() never writes and never starts over; it
+// walks through marked nodes instead of unlinking them.
+// Unlinked nodes are retired through epochs.
+//
+// Level must be safe to call from several threads at once, as the unseeded
+// GeometricLevel is.
+template <typename T, int ML = 16, class Level = GeometricLevel>
+class LockFreeSkipList : public AbstractTree<T> {
+public:
+	typedef LockFreeSkipListNode<T, ML> NodeType;
+	typedef typename NodeType::Link Link;
+
+	LockFreeSkipList(Level generator = Level()) : generator(generator) {
+		for (int i = 0; i < ML; i++) head[i].store(0, std::memory_order_relaxed);
+	}
+
+	LockFreeSkipList(const LockFreeSkipList &) = delete;
+	LockFreeSkipList & operator=(const LockFreeSkipList &) = delete;
+
+	// No other thread may still be using the list.
+	~LockFreeSkipList() {
+		NodeType* node = node_of(head[0].load());
+		while (node != nullptr) {
+			NodeType* next = node_of(node->forwards[0].load());
+			NodeType::destroy(node);
+			node = next;
+		}
+	}
+
+	bool empty() const override {
+		EpochReclaimer::Guard guard(reclaimer);
+		for (NodeType* node = node_of(head[0].load()); node != nullptr; ) {
+			uintptr_t next = node->forwards[0].load();
+			if (!marked(next)) return false;
+			node = node_of(next);
+		}
+		return true;
+	}
+
+	Optional<T> find(const T & element) override {
+		EpochReclaimer::Guard guard(reclaimer);
+		// Marked nodes are walked through like any other: their links stay
+		// frozen at what followed them when they were deleted, and only the
+		// node the search ends on has to be live.
+		const Link* pred = head;
+		NodeType* curr = nullptr;
+		for (int level = ML; level >= 1; level--) {
+			curr = node_of(pred[level - 1].load(std::memory_order_acquire));
+			while (curr != nullptr && curr->element < element) {
+				pred = curr->forwards;
+				curr = node_of(pred[level - 1].load(std::memory_order_acquire));
+			}
+		}
+		if (curr == nullptr || element < curr->element || marked(curr->forwards[0].load())) return Optional<T>();
+
+		return Optional<T>(curr->element);
+	}
+
+	void insert(const T & element) override {
+		EpochReclaimer::Guard guard(reclaimer);
+		Link* preds[ML + 1];
+		NodeType* succs[ML + 1];
+		int level = generator(ML);
+		NodeType* node = nullptr;
+		while (true) {
+			if (this->search(element, preds, succs)) {
+				if (node != nullptr) NodeType::destroy(node);
+				return;
+			}
+			if (node == nullptr) node = NodeType::make(element, level);
+			for (int lv = 1; lv <= level; lv++) {
+				node->forwards[lv - 1].store(word_of(succs[lv]), std::memory_order_relaxed);
+			}
+			uintptr_t expected = word_of(succs[1]);
+			if (preds[1][0].compare_exchange_strong(expected, word_of(node))) break;
+		}
+
+		// In the set now; the upper links are best effort and stop early if
+		// the node is removed meanwhile.
+		for (int lv = 2; lv <= level; lv++) {
+			while (true) {
+				uintptr_t next = node->forwards[lv - 1].load();
+				if (marked(next)) goto linked;
+				if (next != word_of(succs[lv])
+						&& !node->forwards[lv - 1].compare_exchange_strong(next, word_of(succs[lv]))) {
+					continue;
+				}
+				uintptr_t expected = word_of(succs[lv]);
+				if (preds[lv][lv - 1].compare_exchange_strong(expected, word_of(node))) break;
+				this->search(element, preds, succs);
+				if (succs[1] != node) goto linked;
+			}
+		}
+	linked:
+		// A remover that got in first may have unlinked before we linked;
+		// clean up after it.
+		if (marked(node->forwards[0].load())) this->search(element, preds, succs);
+		this->release(node, guard);
+	}
+
+	void remove(const T & element) override {
+		EpochReclaimer::Guard guard(reclaimer);
+		Link* preds[ML + 1];
+		NodeType* succs[ML + 1];
+		if (!this->search(element, preds, succs)) return;
+
+		NodeType* node = succs[1];
+		for (int lv = node->level; lv >= 2; lv--) {
+			uintptr_t next = node->forwards[lv - 1].load();
+			while (!marked(next)) {
+				node->forwards[lv - 1].compare_exchange_weak(next, next | 1);
+			}
+		}
+		uintptr_t next = node->forwards[0].load();
+		while (true) {
+			// Lost to another remover.
+			if (marked(next)) return;
+			if (node->forwards[0].compare_exchange_strong(next, next | 1)) break;
+		}
+		this->search(element, preds, succs);
+		this->release(node, guard);
+	}
+
+protected:
+
+	Level generator;
+	Link head[ML];
+	mutable EpochReclaimer reclaimer;
+
+	static bool marked(uintptr_t word) {
+		return (word & 1) != 0;
+	}
+
+	static NodeType* node_of(uintptr_t word) {
+		return reinterpret_cast<NodeType*>(word & ~uintptr_t(1));
+	}
+
+	static uintptr_t word_of(NodeType *node) {
+		return reinterpret_cast<uintptr_t>(node);
+	}
+
+	// Fills preds[level] (the links holding the predecessor's forward
+	// pointers) and succs[level] around element at every level, unlinking
+	// every marked node on the way. Returns true if an unmarked node holds
+	// element; it is then succs[1].
+	bool search(const T & element, Link **preds, NodeType **succs) {
+	retry:
+		Link* pred = head;
+		for (int level = ML; level >= 1; level--) {
+			NodeType* curr = node_of(pred[level - 1].load());
+			while (curr != nullptr) {
+				uintptr_t succ = curr->forwards[level - 1].load();
+				while (marked(succ)) {
+					uintptr_t expected = word_of(curr);
+					if (!pred[level - 1].compare_exchange_strong(expected, succ & ~uintptr_t(1))) goto retry;
+					curr = node_of(succ);
+					if (curr == nullptr) break;
+					succ = curr->forwards[level - 1].load();
+				}
+				if (curr == nullptr || !(curr->element < element)) break;
+				pred = curr->forwards;
+				curr = node_of(succ);
+			}
+			preds[level] = pred;
+			succs[level] = curr;
+		}
+		return succs[1] != nullptr && !(element < succs[1]->element);
+	}
+
+	void release(NodeType *node, EpochReclaimer::Guard & guard) {
+		if (node->owners.fetch_sub(1) == 1) guard.retire(node, &NodeType::destroy);
+	}
+
+private:
+
+};
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <ostream>
+#include <type_traits>
+
+#include "node_pool.hpp"
+#include "skiplist_level.hpp"
+#include "tree.hpp"
+
+template <typename T, int ML, class Level>
+class SkipListMemTable;
+
+// An entry never changes once linked, apart from its forward links. A
+// tombstone entry records that element was removed.
+template <typename T, int ML>
+class SkipListMemTableNode {
+	template <typename, int, class> friend class SkipListMemTable;
+public:
+
+protected:
+
+	typedef std::atomic<SkipListMemTableNode*> Link;
+
+	const T element;
+	const bool tombstone;
+	const int level;
+	Link forwards[1];
+
+	SkipListMemTableNode(const T & element, bool tombstone, int level) : element(element), tombstone(tombstone), level(level) {
+		for (int i = 1; i < level; i++) {
+			new (&forwards[i]) Link(nullptr);
+		}
+		forwards[0].store(nullptr, std::memory_order_relaxed);
+	}
+
+	static size_t bytes(int level) {
+		return sizeof(SkipListMemTableNode) + (level - 1) * sizeof(Link);
+	}
+
+private:
+
+};
+
+// Append-only skip list for a write buffer, in the manner of LevelDB's
+// memtable: one thread writes, any number of threads read at the same time
+// without locks, and nothing is freed until the table is dropped.
+//
+// Entries are bump-allocated from an arena, and a new entry is published by
+// release-storing the links into it bottom up, so a reader that reaches it
+// through an acquire load sees it whole. Every insert() and remove() links
+// a new entry in front of the older entries for the same element; remove()
+// links a tombstone, even when this table holds no entry for the element,
+// so the delete still reaches older tables when this one is flushed. The
+// first entry for an element is the current one.
+// Dropping the table frees the arena's chunks without visiting the entries
+// (unless T has a destructor to run).
+//
+// insert() and remove() must come from one thread at a time; find(),
+// empty(), size() and Iterator may be used from any thread alongside them.
+template <typename T, int ML = 16, class Level = GeometricLevel>
+class SkipListMemTable : public AbstractTree<T> {
+public:
+	typedef SkipListMemTableNode<T, ML> NodeType;
+	typedef typename NodeType::Link Link;
+
+	SkipListMemTable(Level generator = Level()) : generator(generator), height(1), live(0) {
+		for (int i = 0; i < ML; i++) head[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	SkipListMemTable(const SkipListMemTable &) = delete;
+	SkipListMemTable & operator=(const SkipListMemTable &) = delete;
+
+	// No reader may still be using the table.
+	virtual ~SkipListMemTable() {
+		if (!std::is_trivially_destructible<T>::value) {
+			NodeType* node = head[0].load();
+			while (node != nullptr) {
+				NodeType* next = node->forwards[0].load();
+				node->~NodeType();
+				node = next;
+			}
+		}
+	}
+
+	// Walks the current entry of each element in order, tombstones included.
+	// Entries written after the iterator has passed their place are missed;
+	// entries written ahead of it are seen.
+	class Iterator {
+	public:
+
+		explicit Iterator(const SkipListMemTable & table) : table(table), node(nullptr) {
+		}
+
+		bool valid() const {
+			return node != nullptr;
+		}
+
+		// Only while valid().
+		const T & element() const {
+			return node->element;
+		}
+
+		// True when the current entry is a tombstone: the element was removed,
+		// whether or not this table ever held it. Only while valid().
+		bool deleted() const {
+			return node->tombstone;
+		}
+
+		void seek_to_first() {
+			node = table.head[0].load(std::memory_order_acquire);
+		}
+
+		// Positions the iterator at the first element not less than element.
+		void seek(const T & element) {
+			node = table.seek(element);
+		}
+
+		// Steps past the older entries for the same element.
+		void next() {
+			const T & element = node->element;
+			do {
+				node = node->forwards[0].load(std::memory_order_acquire);
+			} while (node != nullptr && !(element < node->element));
+		}
+
+	protected:
+
+		const SkipListMemTable & table;
+		NodeType* node;
+
+	private:
+
+	};
+
+	Optional<T> find(const T & element) override {
+		NodeType* node = this->seek(element);
+		if (node != nullptr && !(element < node->element) && !node->tombstone) {
+			return Optional<T>(node->element);
+		}
+		return Optional<T>();
+	}
+
+	void insert(const T & element) override {
+		this->append(element, false);
+	}
+
+	void remove(const T & element) override {
+		this->append(element, true);
+	}
+
+	// Number of elements present, not counting tombstones or older entries.
+	size_t size() const {
+		return live.load(std::memory_order_relaxed);
+	}
+
+	bool empty() const override {
+		return size() == 0;
+	}
+
+	void print(std::ostream & stream) const override {
+		Iterator it(*this);
+		for (it.seek_to_first(); it.valid(); it.next()) {
+			if (!it.deleted()) stream << "(" << it.element() << ")" << std::endl;
+		}
+	}
+
+protected:
+
+	NodeArena<alignof(NodeType)> arena;
+	Level generator;
+	Link head[ML];
+	// Highest level in use; readers may see it ahead of the links it covers,
+	// which then still read as null.
+	std::atomic<int> height;
+	std::atomic<size_t> live;
+
+	// First entry not less than element: its current entry, if it has any.
+	NodeType* seek(const T & element) const {
+		const Link* pred = head;
+		NodeType* next = nullptr;
+		for (int level = height.load(std::memory_order_relaxed); level >= 1; level--) {
+			next = pred[level - 1].load(std::memory_order_acquire);
+			while (next != nullptr && next->element < element) {
+				pred = next->forwards;
+				next = pred[level - 1].load(std::memory_order_acquire);
+			}
+		}
+		return next;
+	}
+
+	// Links a new entry for element in front of its older entries. Only
+	// this thread writes links, so its own loads need no ordering.
+	void append(const T & element, bool tombstone) {
+		Link* preds[ML + 1];
+		int top = height.load(std::memory_order_relaxed);
+		Link* pred = head;
+		NodeType* next = nullptr;
+		for (int level = top; level >= 1; level--) {
+			next = pred[level - 1].load(std::memory_order_relaxed);
+			while (next != nullptr && next->element < element) {
+				pred = next->forwards;
+				next = pred[level - 1].load(std::memory_order_relaxed);
+			}
+			preds[level] = pred;
+		}
+		bool present = next != nullptr && !(element < next->element) && !next->tombstone;
+
+		int level = this->generator(ML);
+		if (level > top) {
+			for (int lv = top + 1; lv <= level; lv++) {
+				preds[lv] = head;
+			}
+			height.store(level, std::memory_order_relaxed);
+		}
+		NodeType* node = new (arena.allocate(NodeType::bytes(level))) NodeType(element, tombstone, level);
+		for (int lv = 1; lv <= level; lv++) {
+			node->forwards[lv - 1].store(preds[lv][lv - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		for (int lv = 1; lv <= level; lv++) {
+			preds[lv][lv - 1].store(node, std::memory_order_release);
+		}
+		if (present == tombstone) {
+			live.store(tombstone ? size() - 1 : size() + 1, std::memory_order_relaxed);
+		}
+	}
+
+private:
+
+};
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+#include "epoch.hpp"
+#include "skiplist_level.hpp"
+#include "tree.hpp"
+
+template <typename T, int ML, class Level>
+class SkipListPriorityQueue;
+
+// Level 1 links carry a mark in the low bit: a marked link means the node
+// it points to has been taken by pop_min(). Upper links are never marked.
+template <typename T, int ML>
+class SkipListQueueNode {
+	template <typename, int, class> friend class SkipListPriorityQueue;
+public:
+
+protected:
+
+	typedef std::atomic<uintptr_t> Link;
+
+	const T element;
+	const int level;
+	// Set until push() stops linking the upper levels; pop_min() does not
+	// cut the deleted prefix past such a node.
+	std::atomic<bool> inserting;
+	// Set by the pop_min() that took the node, just after its mark.
+	std::atomic<bool> taken;
+	Link forwards[1];
+
+	SkipListQueueNode(const T & element, int level) : element(element), level(level), inserting(true), taken(false) {
+		for (int i = 1; i < level; i++) {
+			new (&forwards[i]) Link(0);
+		}
+		forwards[0].store(0, std::memory_order_relaxed);
+	}
+
+	static size_t bytes(int level) {
+		return sizeof(SkipListQueueNode) + (level - 1) * sizeof(Link);
+	}
+
+	static SkipListQueueNode* make(const T & element, int level) {
+		return new (::operator new(bytes(level))) SkipListQueueNode(element, level);
+	}
+
+	static void destroy(void *pointer) {
+		static_cast<SkipListQueueNode*>(pointer)->~SkipListQueueNode();
+		::operator delete(pointer);
+	}
+
+private:
+
+};
+
+// Lock-free priority queue on a skip list (Linden and Jonsson, "A
+// Skiplist-Based Concurrent Priority Queue with Minimal Memory Contention").
+//
+// pop_min() deletes logically by marking the level 1 link into the first
+// live node with one fetch-or, so taking the minimum costs one atomic and
+// the taken nodes pile up as a deleted prefix at the front of the list.
+// Only when that prefix is longer than bound does a pop_min() cut it off,
+// with a single CAS on the head, and then repair the upper head links; the
+// cut nodes are retired through epochs. push() never links a node into
+// the deleted prefix. Equal elements come out in the order they went in.
+//
+// Level must be safe to call from several threads at once, as the unseeded
+// GeometricLevel is.
+template <typename T, int ML = 16, class Level = GeometricLevel>
+class SkipListPriorityQueue {
+public:
+	typedef SkipListQueueNode<T, ML> NodeType;
+	typedef typename NodeType::Link Link;
+
+	explicit SkipListPriorityQueue(int bound = 32, Level generator = Level()) : bound(bound), generator(generator) {
+		for (int i = 0; i < ML; i++) head[i].store(0, std::memory_order_relaxed);
+	}
+
+	SkipListPriorityQueue(const SkipListPriorityQueue &) = delete;
+	SkipListPriorityQueue & operator=(const SkipListPriorityQueue &) = delete;
+
+	// No other thread may still be using the queue.
+	~SkipListPriorityQueue() {
+		NodeType* node = node_of(head[0].load());
+		while (node != nullptr) {
+			NodeType* next = node_of(node->forwards[0].load());
+			NodeType::destroy(node);
+			node = next;
+		}
+	}
+
+	bool empty() const {
+		EpochReclaimer::Guard guard(reclaimer);
+		const Link* links = head;
+		uintptr_t next = links[0].load();
+		while (marked(next)) {
+			links = node_of(next)->forwards;
+			next = links[0].load();
+		}
+		return next == 0;
+	}
+
+	void push(const T & element) {
+		EpochReclaimer::Guard guard(reclaimer);
+		Link* preds[ML + 1];
+		NodeType* succs[ML + 1];
+		int level = generator(ML);
+		NodeType* node = NodeType::make(element, level);
+		NodeType* deleted;
+		while (true) {
+			deleted = this->locate(element, preds, succs);
+			node->forwards[0].store(word_of(succs[1]), std::memory_order_relaxed);
+			uintptr_t expected = word_of(succs[1]);
+			if (preds[1][0].compare_exchange_strong(expected, word_of(node))) break;
+		}
+
+		for (int lv = 2; lv <= level; ) {
+			node->forwards[lv - 1].store(word_of(succs[lv]));
+			// Stop once the node itself is taken, or when the successor is
+			// (or may soon be) cut off with the deleted prefix.
+			if (marked(node->forwards[0].load())
+					|| (succs[lv] != nullptr && (succs[lv] == deleted || marked(succs[lv]->forwards[0].load())))) {
+				break;
+			}
+			uintptr_t expected = word_of(succs[lv]);
+			if (preds[lv][lv - 1].compare_exchange_strong(expected, word_of(node))) {
+				lv++;
+			} else {
+				deleted = this->locate(element, preds, succs);
+				if (succs[1] != node) break;
+			}
+		}
+		node->inserting.store(false);
+	}
+
+	// Takes the least element, or nothing when the queue is empty.
+	Optional<T> pop_min() {
+		EpochReclaimer::Guard guard(reclaimer);
+		uintptr_t observed = head[0].load();
+		Link* links = head;
+		NodeType* node = nullptr;
+		NodeType* cut = nullptr;
+		int offset = 0;
+		uintptr_t next;
+		do {
+			next = links[0].load();
+			if (node_of(next) == nullptr) return Optional<T>();
+			if (cut == nullptr && node != nullptr && node->inserting.load()) cut = node;
+			// Only a link seen unmarked needs the atomic; a marked one stays so.
+			if (!marked(next)) next = links[0].fetch_or(1);
+			offset++;
+			node = node_of(next);
+			links = node->forwards;
+		} while (marked(next));
+		node->taken.store(true);
+
+		Optional<T> result(node->element);
+		if (offset < bound) return result;
+
+		// Cut the deleted prefix up to the newest taken node (or the first
+		// node still being pushed), which stays as the new front.
+		if (cut == nullptr) cut = node;
+		if (head[0].compare_exchange_strong(observed, word_of(cut) | 1)) {
+			this->restructure();
+			for (NodeType* dead = node_of(observed); dead != cut; ) {
+				NodeType* following = node_of(dead->forwards[0].load());
+				guard.retire(dead, &NodeType::destroy);
+				dead = following;
+			}
+		}
+		return result;
+	}
+
+protected:
+
+	int bound;
+	Level generator;
+	Link head[ML];
+	mutable EpochReclaimer reclaimer;
+
+	static bool marked(uintptr_t word) {
+		return (word & 1) != 0;
+	}
+
+	static NodeType* node_of(uintptr_t word) {
+		return reinterpret_cast<NodeType*>(word & ~uintptr_t(1));
+	}
+
+	static uintptr_t word_of(NodeType *node) {
+		return reinterpret_cast<uintptr_t>(node);
+	}
+
+	// A node whose own level 1 link is marked has been taken and so has its
+	// successor, so it is well inside the deleted prefix.
+	static bool buried(NodeType *node) {
+		return node != nullptr && marked(node->forwards[0].load());
+	}
+
+	// Fills preds and succs for pushing element after every live element
+	// not greater than it and after the whole deleted prefix. Returns the
+	// last taken node met on level 1, if any. Taken nodes are passed on the
+	// upper levels too, whatever their element: otherwise an element less
+	// than the last one taken would stop in front of that node there and
+	// get no upper links, and once pop_min() falls behind such nodes pile
+	// up at the front as a plain linked list.
+	NodeType* locate(const T & element, Link **preds, NodeType **succs) {
+		Link* pred = head;
+		NodeType* deleted = nullptr;
+		for (int level = ML; level >= 1; level--) {
+			uintptr_t word = pred[level - 1].load();
+			NodeType* curr = node_of(word);
+			while (curr != nullptr
+					&& (!(element < curr->element) || curr->taken.load() || buried(curr) || (level == 1 && marked(word)))) {
+				if (level == 1 && marked(word)) deleted = curr;
+				pred = curr->forwards;
+				word = pred[level - 1].load();
+				curr = node_of(word);
+			}
+			preds[level] = pred;
+			succs[level] = curr;
+		}
+		return deleted;
+	}
+
+	// Moves the upper head links past the nodes cut off with the prefix.
+	void restructure() {
+		Link* pred = head;
+		for (int level = ML; level > 1; ) {
+			uintptr_t first = head[level - 1].load();
+			if (!buried(node_of(first))) {
+				level--;
+				continue;
+			}
+			NodeType* curr = node_of(pred[level - 1].load());
+			while (buried(curr)) {
+				pred = curr->forwards;
+				curr = node_of(pred[level - 1].load());
+			}
+			if (head[level - 1].compare_exchange_strong(first, word_of(curr))) level--;
+		}
+	}
+
+private:
+
+};
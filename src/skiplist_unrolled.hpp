@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <type_traits>
+
+#include "node_pool.hpp"
+#include "skiplist_level.hpp"
+#include "tree.hpp"
+
+template <typename T, int B, int ML, class Level>
+class UnrolledSkipList;
+
+// Up to B sorted elements and, as in SkipListNode, exactly level forward
+// links. The skip levels index nodes by their first element.
+template <typename T, int B, int ML>
+class UnrolledSkipListNode {
+	template <typename, int, int, class> friend class UnrolledSkipList;
+public:
+
+protected:
+
+	// Integral elements are searched with a branchless pass over all B
+	// slots, which compilers turn into vector compares; the slots past count
+	// hold the largest value so they never count as less. Floating point
+	// takes the lower_bound path, since infinity would count past the
+	// filler; NaN keys are not supported either way.
+	static const bool packed = std::is_integral<T>::value;
+
+	int count;
+	int level;
+	T elements[B];
+	UnrolledSkipListNode* forwards[1];
+
+	explicit UnrolledSkipListNode(int level) : count(0), level(level) {
+		if (packed) std::fill(elements, elements + B, std::numeric_limits<T>::max());
+		for (int i = 1; i <= level; i++) {
+			this->next(i) = nullptr;
+		}
+	}
+
+	static size_t bytes(int level) {
+		return sizeof(UnrolledSkipListNode) + (level - 1) * sizeof(UnrolledSkipListNode*);
+	}
+
+	UnrolledSkipListNode*& next(int level) {
+		return forwards[level - 1];
+	}
+
+	// Number of elements less than element.
+	int rank(const T & element) const {
+		if (packed) {
+			int less = 0;
+			for (int i = 0; i < B; i++) {
+				less += elements[i] < element;
+			}
+			return less;
+		}
+		return int(std::lower_bound(elements, elements + count, element) - elements);
+	}
+
+	void insert_at(int index, const T & element) {
+		std::copy_backward(elements + index, elements + count, elements + count + 1);
+		elements[index] = element;
+		count++;
+	}
+
+	void erase_at(int index) {
+		std::copy(elements + index + 1, elements + count, elements + index);
+		count--;
+		if (packed) elements[count] = std::numeric_limits<T>::max();
+	}
+
+private:
+
+};
+
+// Skip list whose bottom level is unrolled: every node holds up to B
+// sorted elements (by default two cache lines' worth), and the levels above
+// index whole nodes by their first element. A lookup makes about log(n / B)
+// hops and then searches one small contiguous array; a range scan reads
+// elements back to back instead of one node per element.
+//
+// A full node splits in half; a node that drops below B / 4 elements
+// merges with its successor when both fit in half a node, and a node
+// losing its last element is unlinked.
+template <typename T, int B = (128 / sizeof(T) < 4 ? 4 : 128 / sizeof(T)), int ML = 16, class Level = GeometricLevel>
+class UnrolledSkipList : public AbstractTree<T> {
+public:
+	typedef UnrolledSkipListNode<T, B, ML> NodeType;
+
+	UnrolledSkipList(Level generator = Level()) : generator(generator), max_curr_level(1) {
+		header = newNode(ML);
+	}
+
+	UnrolledSkipList(const UnrolledSkipList &) = delete;
+	UnrolledSkipList & operator=(const UnrolledSkipList &) = delete;
+
+	virtual ~UnrolledSkipList() {
+		if (!std::is_trivially_destructible<T>::value) {
+			NodeType* currNode = header;
+			while (currNode != nullptr) {
+				NodeType* tempNode = currNode;
+				currNode = currNode->next(1);
+				tempNode->~NodeType();
+			}
+		}
+	}
+
+	bool empty() const override {
+		return header->next(1) == nullptr;
+	}
+
+	Optional<T> find(const T & element) override {
+		NodeType* node = this->locate(element, nullptr);
+		if (node == header) return Optional<T>();
+
+		int index = node->rank(element);
+		if (index < node->count && !(element < node->elements[index])) {
+			return Optional<T>(node->elements[index]);
+		}
+		return Optional<T>();
+	}
+
+	void insert(const T & element) override {
+		NodeType* update[ML + 1];
+		NodeType* node = this->locate(element, update);
+		if (node == header) {
+			// Before every element: goes to the front of the first node.
+			node = header->next(1);
+			if (node == nullptr) {
+				node = this->link(update);
+			}
+		}
+
+		int index = node->rank(element);
+		if (index < node->count && !(element < node->elements[index])) return;
+
+		if (node->count == B) {
+			NodeType* half = this->split(node, update);
+			if (index > B / 2) {
+				node = half;
+				index -= B / 2;
+			}
+		}
+		node->insert_at(index, element);
+	}
+
+	void remove(const T & element) override {
+		NodeType* update[ML + 1];
+		NodeType* node = this->locate(element, update);
+		if (node == header) return;
+
+		int index = node->rank(element);
+		if (index == node->count || element < node->elements[index]) return;
+
+		if (node->count == 1) {
+			this->unlink(node);
+			return;
+		}
+		node->erase_at(index);
+		if (node->count < B / 4) {
+			NodeType* next = node->next(1);
+			if (next != nullptr && node->count + next->count <= B / 2) {
+				std::copy(next->elements, next->elements + next->count, node->elements + node->count);
+				node->count += next->count;
+				this->unlink(next);
+			}
+		}
+	}
+
+	void clear() override {
+		NodeType* currNode = header->next(1);
+		while (currNode != nullptr) {
+			NodeType* tempNode = currNode;
+			currNode = currNode->next(1);
+			deleteNode(tempNode);
+		}
+		for (int i = 1; i <= ML; i++) {
+			header->next(i) = nullptr;
+		}
+		max_curr_level = 1;
+	}
+
+	// Calls visit(element) for every element x with lo <= x <= hi, in order.
+	template <class F>
+	void for_each(const T & lo, const T & hi, F visit) {
+		NodeType* node = this->locate(lo, nullptr);
+		int index = 0;
+		if (node == header) {
+			node = header->next(1);
+		} else {
+			index = node->rank(lo);
+		}
+		for (; node != nullptr; node = node->next(1), index = 0) {
+			for (; index < node->count; index++) {
+				if (hi < node->elements[index]) return;
+				visit(node->elements[index]);
+			}
+		}
+	}
+
+	void print(std::ostream & stream) const override {
+		for (NodeType* currNode = header->next(1); currNode != nullptr; currNode = currNode->next(1)) {
+			for (int i = 0; i < currNode->count; i++) {
+				stream << "(" << currNode->elements[i] << ")" << std::endl;
+			}
+		}
+	}
+
+protected:
+
+	NodeArena<alignof(NodeType)> arena;
+	Level generator;
+	int max_curr_level;
+	NodeType* header;
+
+	// Last node whose first element is not greater than element (header if
+	// none), filling update[lv] with the last such node on every level.
+	NodeType* locate(const T & element, NodeType** update) {
+		NodeType* currNode = header;
+		for (int level = max_curr_level; level >= 1; level--) {
+			NodeType* next = currNode->next(level);
+			while (next != nullptr && !(element < next->elements[0])) {
+				currNode = next;
+				next = currNode->next(level);
+			}
+			if (update != nullptr) update[level] = currNode;
+		}
+		return currNode;
+	}
+
+	// Links a new empty node after update[lv] on each of its levels.
+	NodeType* link(NodeType** update) {
+		int newlevel = this->generator(ML);
+		if (newlevel > max_curr_level) {
+			for (int level = max_curr_level + 1; level <= newlevel; level++) {
+				update[level] = header;
+			}
+			max_curr_level = newlevel;
+		}
+		NodeType* node = newNode(newlevel);
+		for (int lv = 1; lv <= newlevel; lv++) {
+			node->next(lv) = update[lv]->next(lv);
+			update[lv]->next(lv) = node;
+		}
+		return node;
+	}
+
+	// Moves the upper half of a full node into a new node right after it.
+	// update[] is the search path that ended at node.
+	NodeType* split(NodeType *node, NodeType** update) {
+		// On the levels node has, the new node follows node itself.
+		for (int lv = 1; lv <= node->level && lv <= max_curr_level; lv++) {
+			update[lv] = node;
+		}
+		NodeType* half = this->link(update);
+		std::copy(node->elements + B / 2, node->elements + B, half->elements);
+		half->count = B - B / 2;
+		if (NodeType::packed) std::fill(node->elements + B / 2, node->elements + B, std::numeric_limits<T>::max());
+		node->count = B / 2;
+		return half;
+	}
+
+	// Unlinks a non-empty node from every level and frees it.
+	void unlink(NodeType *node) {
+		NodeType* currNode = header;
+		for (int level = max_curr_level; level >= 1; level--) {
+			NodeType* next = currNode->next(level);
+			while (next != nullptr && next->elements[0] < node->elements[0]) {
+				currNode = next;
+				next = currNode->next(level);
+			}
+			if (next == node) currNode->next(level) = node->next(level);
+		}
+		deleteNode(node);
+		while (max_curr_level > 1 && header->next(max_curr_level) == nullptr) {
+			max_curr_level--;
+		}
+	}
+
+	NodeType* newNode(int level) {
+		return new (arena.allocate(NodeType::bytes(level))) NodeType(level);
+	}
+
+	void deleteNode(NodeType *node) {
+		int level = node->level;
+		node->~NodeType();
+		arena.deallocate(node, NodeType::bytes(level));
+	}
+
+private:
+
+};
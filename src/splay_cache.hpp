@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+
+#include "splay_tree.hpp"
+
+// Element of a SplayCache with the time it was last touched. Entries order
+// by element alone.
+template <typename T>
+struct SplayCacheEntry
+{
+    T element;
+    unsigned long stamp;
+
+    SplayCacheEntry() : element(), stamp(0) { }
+
+    SplayCacheEntry(const T& element, unsigned long stamp = 0) : element(element), stamp(stamp) { }
+
+    bool operator<(const SplayCacheEntry& other) const { return element < other.element; }
+    bool operator>(const SplayCacheEntry& other) const { return other.element < element; }
+    bool operator!=(const SplayCacheEntry& other) const { return *this < other || *this > other; }
+};
+
+// Ordered cache with at most capacity elements. Every hit or insert splays
+// the element to the root, so the working set stays near the top and costs
+// O(log working set) to reach. When full, put() evicts a cold element: it
+// walks down from the root always taking the child touched longer ago, and
+// evicts the leaf it ends on, an approximation of least recently used.
+template <typename T>
+class SplayCache : public AbstractTree<T>
+{
+    public:
+        typedef SplayTreeNode<SplayCacheEntry<T>> splay;
+
+        explicit SplayCache(size_t capacity) : limit(capacity ? capacity : 1), count(0), clock(0)
+        {
+        }
+
+        size_t capacity() const { return limit; }
+
+        size_t size() const { return count; }
+
+        bool empty() const override { return count == 0; }
+
+        Optional<T> find(const T & element) override
+        {
+            Optional<SplayCacheEntry<T>> found = tree.find(SplayCacheEntry<T>(element));
+            if (!found.has())
+                return Optional<T>();
+            tree.root->element.stamp = ++clock;
+            return Optional<T>(found.get().element);
+        }
+
+        void insert(const T & element) override
+        {
+            put(element);
+        }
+
+        // Inserts element, or refreshes it when already cached. Returns the
+        // element evicted to make room, if any.
+        Optional<T> put(const T & element)
+        {
+            if (find(element).has())
+                return Optional<T>();
+
+            tree.insert(SplayCacheEntry<T>(element, ++clock));
+            if (++count <= limit)
+                return Optional<T>();
+
+            splay* node = tree.root;
+            while (node->left || node->right)
+            {
+                if (!node->right || (node->left && node->left->element.stamp < node->right->element.stamp))
+                    node = node->left;
+                else
+                    node = node->right;
+            }
+            T victim = node->element.element;
+            tree.remove(node->element);
+            count--;
+            return Optional<T>(victim);
+        }
+
+        void clear() override
+        {
+            tree.clear();
+            count = 0;
+        }
+
+        void remove(const T & element) override
+        {
+            if (!tree.find(SplayCacheEntry<T>(element)).has())
+                return;
+            tree.remove(SplayCacheEntry<T>(element));
+            count--;
+        }
+
+    protected:
+
+        SplayTree<SplayCacheEntry<T>> tree;
+        size_t limit;
+        size_t count;
+        unsigned long clock;
+};
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "tree.hpp"
+
+template<typename T>
+class SplaySequence;
+
+template<typename T>
+class SplaySequenceNode {
+	friend class SplaySequence<T>;
+public:
+
+protected:
+
+	T element;
+	SplaySequenceNode *left;
+	SplaySequenceNode *right;
+	// Nodes in this subtree, this one included.
+	size_t size;
+
+	SplaySequenceNode(const T& init) : element(init), left(nullptr), right(nullptr), size(1) {
+	}
+
+private:
+};
+
+// Sequence kept in a splay tree keyed by position instead of by value: a
+// node's index is the number of nodes before it in order, read off the
+// subtree sizes. Inserting or erasing shifts every later index without
+// touching those nodes, and every operation is amortized O(log n).
+template <typename T>
+class SplaySequence
+{
+    public:
+        typedef SplaySequenceNode<T> splay;
+
+        SplaySequence() : root(nullptr)
+        {
+        }
+
+        SplaySequence(SplaySequence&& other) : root(other.root)
+        {
+            other.root = nullptr;
+        }
+
+        SplaySequence& operator=(SplaySequence&& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                root = other.root;
+                other.root = nullptr;
+            }
+            return *this;
+        }
+
+        SplaySequence(const SplaySequence&) = delete;
+        SplaySequence& operator=(const SplaySequence&) = delete;
+
+        ~SplaySequence()
+        {
+            clear();
+        }
+
+        size_t size() const
+        {
+            return size_of(root);
+        }
+
+        bool empty() const
+        {
+            return root == nullptr;
+        }
+
+        void clear()
+        {
+            dispose(root);
+            root = nullptr;
+        }
+
+        // Element at index, or nothing when index >= size().
+        Optional<T> at(size_t index)
+        {
+            if (index >= size())
+                return Optional<T>();
+            root = Splay(index, root);
+            return Optional<T>(root->element);
+        }
+
+        // Inserts element so that it ends up at index; index == size()
+        // appends. Does nothing when index > size().
+        void insert_at(size_t index, const T & element)
+        {
+            size_t count = size();
+            if (index > count)
+                return;
+            splay* node = new splay(element);
+            if (index == count)
+            {
+                node->left = root;
+            }
+            else
+            {
+                root = Splay(index, root);
+                node->left = root->left;
+                root->left = nullptr;
+                root->size = size_of(root->right) + 1;
+                node->right = root;
+            }
+            node->size = count + 1;
+            root = node;
+        }
+
+        void push_back(const T & element)
+        {
+            insert_at(size(), element);
+        }
+
+        void erase_at(size_t index)
+        {
+            erase_range(index, index + 1);
+        }
+
+        // Erases the elements at indices first up to but not including last.
+        void erase_range(size_t first, size_t last)
+        {
+            if (last > size())
+                last = size();
+            if (first >= last)
+                return;
+            SplaySequence tail = split(last);
+            SplaySequence middle = split(first);
+            concat(std::move(tail));
+        }
+
+        // Moves the elements from index on into the returned sequence.
+        SplaySequence split(size_t index)
+        {
+            SplaySequence tail;
+            if (index >= size())
+                return tail;
+            root = Splay(index, root);
+            tail.root = root;
+            root = root->left;
+            tail.root->left = nullptr;
+            tail.root->size = size_of(tail.root->right) + 1;
+            return tail;
+        }
+
+        // Appends every element of other, leaving it empty.
+        void concat(SplaySequence&& other)
+        {
+            if (this == &other || !other.root)
+                return;
+            if (!root)
+            {
+                root = other.root;
+            }
+            else
+            {
+                // The last element has no right subtree once splayed.
+                root = Splay(root->size - 1, root);
+                root->right = other.root;
+                root->size += other.root->size;
+            }
+            other.root = nullptr;
+        }
+
+        // Calls visit(element) for the elements in order.
+        template<typename F>
+        void for_each(F visit) const
+        {
+            std::vector<splay*> stack;
+            for (splay* node = root; node || !stack.empty(); node = node->right)
+            {
+                for (; node; node = node->left)
+                    stack.push_back(node);
+                node = stack.back();
+                stack.pop_back();
+                visit(node->element);
+            }
+        }
+
+    protected:
+
+        splay* root;
+
+        static size_t size_of(splay* node)
+        {
+            return node ? node->size : 0;
+        }
+
+        // RR(Y rotates to the right)
+        static splay* RR_Rotate(splay* k2)
+        {
+            splay* k1 = k2->left;
+            k2->left = k1->right;
+            k1->right = k2;
+            k1->size = k2->size;
+            k2->size = size_of(k2->left) + size_of(k2->right) + 1;
+            return k1;
+        }
+
+        // LL(Y rotates to the left)
+        static splay* LL_Rotate(splay* k2)
+        {
+            splay* k1 = k2->right;
+            k2->right = k1->left;
+            k1->left = k2;
+            k1->size = k2->size;
+            k2->size = size_of(k2->left) + size_of(k2->right) + 1;
+            return k1;
+        }
+
+        // Top-down splay of the node at index (which must be < size of
+        // root), the same walk as SplayTree::Splay with ranks in place of
+        // comparisons. The sizes along the spines of the L and R trees are
+        // fixed up after assembly, from the totals gathered on the way down.
+        static splay* Splay(size_t index, splay* root)
+        {
+            splay* LeftTree = nullptr;
+            splay* LeftTreeMax = nullptr;
+            splay* RightTree = nullptr;
+            splay* RightTreeMin = nullptr;
+            size_t leftSize = 0;
+            size_t rightSize = 0;
+            while (1)
+            {
+                size_t rank = size_of(root->left);
+                if (index < rank)
+                {
+                    if (index < size_of(root->left->left))
+                        root = RR_Rotate(root);
+                    /* Link to R Tree */
+                    rightSize += size_of(root->right) + 1;
+                    if (RightTreeMin)
+                        RightTreeMin->left = root;
+                    else
+                        RightTree = root;
+                    RightTreeMin = root;
+                    root = root->left;
+                }
+                else if (index > rank)
+                {
+                    index -= rank + 1;
+                    size_t below = size_of(root->right->left);
+                    if (index > below)
+                    {
+                        root = LL_Rotate(root);
+                        index -= below + 1;
+                    }
+                    /* Link to L Tree */
+                    leftSize += size_of(root->left) + 1;
+                    if (LeftTreeMax)
+                        LeftTreeMax->right = root;
+                    else
+                        LeftTree = root;
+                    LeftTreeMax = root;
+                    root = root->right;
+                }
+                else
+                    break;
+            }
+
+            /* assemble L Tree, Middle Tree and R tree */
+            leftSize += size_of(root->left);
+            rightSize += size_of(root->right);
+            root->size = leftSize + rightSize + 1;
+            if (LeftTreeMax)
+            {
+                LeftTreeMax->right = root->left;
+                for (splay* node = LeftTree;; node = node->right)
+                {
+                    node->size = leftSize;
+                    leftSize -= size_of(node->left) + 1;
+                    if (node == LeftTreeMax)
+                        break;
+                }
+                root->left = LeftTree;
+            }
+            if (RightTreeMin)
+            {
+                RightTreeMin->left = root->right;
+                for (splay* node = RightTree;; node = node->left)
+                {
+                    node->size = rightSize;
+                    rightSize -= size_of(node->right) + 1;
+                    if (node == RightTreeMin)
+                        break;
+                }
+                root->right = RightTree;
+            }
+            return root;
+        }
+
+        // Frees a subtree without recursion by rotating left children up.
+        static void dispose(splay* node)
+        {
+            while (node)
+            {
+                if (node->left)
+                {
+                    node = RR_Rotate(node);
+                }
+                else
+                {
+                    splay* right = node->right;
+                    delete node;
+                    node = right;
+                }
+            }
+        }
+};
@@ -1,15 +1,82 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <type_traits>
+#include <vector>
 
+#include "node_pool.hpp"
 #include "tree.hpp"
 
-template<typename T>
+// Splay policies decide whether find() restructures the tree. splay(depth)
+// is asked after a plain search that stopped depth links below the root;
+// a lookup it declines is a pure read. SplayAlways keeps the classic
+// behaviour of splaying on every access without the extra search.
+struct SplayAlways
+{
+    static const bool always = true;
+    bool splay(int) { return true; }
+};
+
+// Splays with probability p. Each tree draws from its own generator, so the
+// same seed and the same lookups splay the same way.
+struct SplayProbabilistic
+{
+    static const bool always = false;
+    uint32_t threshold;
+    uint32_t state;
+
+    explicit SplayProbabilistic(double p = 0.1, uint32_t seed = 2463534242u) : threshold(p >= 1.0 ? UINT32_MAX : uint32_t(p * 4294967296.0)), state(seed == 0 ? 1 : seed) { }
+
+    bool splay(int)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state < threshold;
+    }
+};
+
+// Splays only when the access went deeper than threshold.
+struct SplayDepthThreshold
+{
+    static const bool always = false;
+    int threshold;
+
+    explicit SplayDepthThreshold(int threshold = 16) : threshold(threshold) { }
+
+    bool splay(int depth) { return depth > threshold; }
+};
+
+// Splays once every k lookups on the tree.
+struct SplayEveryK
+{
+    static const bool always = false;
+    unsigned k;
+    unsigned count;
+
+    explicit SplayEveryK(unsigned k = 8) : k(k), count(0) { }
+
+    bool splay(int)
+    {
+        if (++count < k)
+            return false;
+        count = 0;
+        return true;
+    }
+};
+
+template<typename T, typename Policy = SplayAlways>
 class SplayTree;
 
+template<typename T>
+class SplayCache;
+
 template<typename T>
 class SplayTreeNode {
-	friend class SplayTree<T>;
+	template<typename, typename> friend class SplayTree;
+	template<typename> friend class SplayCache;
 public:
 
 protected:
@@ -24,18 +91,54 @@ protected:
 private:
 };
 
-template <typename T>
+template <typename T, typename Policy>
 class SplayTree : public AbstractTree<T>
 {
     public:
 		typedef SplayTreeNode<T> splay;
 
 		splay *root = nullptr;
+		Policy policy;
+		// Nodes come from here; remove() hands them back for reuse.
+		NodePool<splay> pool;
 
-        SplayTree()
+        SplayTree(Policy policy = Policy()) : policy(policy)
         {
         }
 
+        SplayTree(const SplayTree&) = delete;
+        SplayTree& operator=(const SplayTree&) = delete;
+
+        ~SplayTree()
+        {
+            clear();
+        }
+
+        // Drops every node. Nodes whose element needs no destructor are not
+        // even visited; their chunks go back in one go.
+        void clear() override
+        {
+            if (!std::is_trivially_destructible<T>::value)
+            {
+                // Rotate left children up so the walk needs no stack.
+                while (root)
+                {
+                    if (root->left)
+                    {
+                        root = RR_Rotate(root);
+                    }
+                    else
+                    {
+                        splay* right = root->right;
+                        root->~splay();
+                        root = right;
+                    }
+                }
+            }
+            root = nullptr;
+            pool.release();
+        }
+
         // RR(Y rotates to the right)
         splay* RR_Rotate(splay* k2)
         {
@@ -112,23 +215,24 @@ class SplayTree : public AbstractTree<T>
             return root;
         }
 
-        splay* New_Node(T element)
+        splay* New_Node(const T& element)
         {
-            splay* p_node = new splay(element);
+            splay* p_node = new (pool.allocate()) splay(element);
             return p_node;
         }
 
+        void Delete_Node(splay* node)
+        {
+            node->~splay();
+            pool.deallocate(node);
+        }
+
         void insert(const T & element) override
         {
-            static splay* p_node = nullptr;
-            if (!p_node)
-                p_node = New_Node(element);
-            else
-                p_node->element = element;
+            splay* p_node;
             if (!root)
             {
-                root = p_node;
-                p_node = nullptr;
+                root = New_Node(element);
                 return;
             }
             root = Splay(element, root);
@@ -136,6 +240,7 @@ class SplayTree : public AbstractTree<T>
             root->element is in root->right. */
             if (element < root->element)
             {
+                p_node = New_Node(element);
                 p_node->left = root->left;
                 p_node->right = root;
                 root->left = nullptr;
@@ -143,14 +248,12 @@ class SplayTree : public AbstractTree<T>
             }
             else if (element > root->element)
             {
+                p_node = New_Node(element);
                 p_node->right = root->right;
                 p_node->left = root;
                 root->right = nullptr;
                 root = p_node;
             }
-            else
-                return;
-            p_node = nullptr;
         }
 
         void remove(const T & element)
@@ -177,7 +280,7 @@ class SplayTree : public AbstractTree<T>
                     root = Splay(element, root->left);
                     root->right = temp->right;
                 }
-                delete temp;
+                Delete_Node(temp);
                 return;
             }
         }
@@ -188,7 +291,28 @@ class SplayTree : public AbstractTree<T>
         }
 
 		Optional<T> find(const T & element) override {
-			splay *node = Search(element, root);
+			if (!root)
+				return Optional<T>();
+			if (Policy::always) {
+				root = Search(element, root);
+				if (element < root->element || element > root->element)
+					return Optional<T>();
+				return Optional<T>(root->element);
+			}
+
+			splay *node = root;
+			int depth = 0;
+			while (node) {
+				if (element < node->element)
+					node = node->left;
+				else if (element > node->element)
+					node = node->right;
+				else
+					break;
+				depth++;
+			}
+			if (policy.splay(depth))
+				root = Splay(element, root);
 			if (node) {
 				return Optional<T>(node->element);
 			} else {
@@ -196,6 +320,36 @@ class SplayTree : public AbstractTree<T>
 			}
 		}
 
+        // Looks up a batch of keys, in any order and with repeats, and
+        // returns the ones present in ascending order. The keys are sorted
+        // and splayed one after another, so each search starts from its
+        // predecessor at the root and costs amortized O(log distance)
+        // (the dynamic finger bound) instead of O(log n).
+        std::vector<T> find_batch(std::vector<T> keys)
+        {
+            std::vector<T> found;
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end(), [](const T& a, const T& b) { return !(a < b); }), keys.end());
+            for (const T& key : keys)
+            {
+                if (!root)
+                    break;
+                root = Splay(key, root);
+                if (!(key < root->element) && !(key > root->element))
+                    found.push_back(root->element);
+            }
+            return found;
+        }
+
+        // Inserts a batch of elements in ascending order; each one lands
+        // next to the previous one at the root.
+        void insert_batch(std::vector<T> elements)
+        {
+            std::sort(elements.begin(), elements.end());
+            for (const T& element : elements)
+                insert(element);
+        }
+
 		virtual bool empty() const override {
 			return root == nullptr;
 		}